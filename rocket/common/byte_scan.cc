@@ -0,0 +1,150 @@
+#include <string.h>
+#include <stdint.h>
+#include "rocket/common/byte_scan.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define ROCKET_BYTE_SCAN_X86 1
+#endif
+
+namespace rocket
+{
+
+  typedef const char *(*FindFirstOf2Func)(const char *begin, const char *end, char a, char b);
+
+#ifdef ROCKET_BYTE_SCAN_X86
+
+  // SSE2 是 x86_64 的基线指令集，不需要检测
+  static const char *findFirstOf2Sse2(const char *begin, const char *end, char a, char b)
+  {
+    const char *p = begin;
+    __m128i va = _mm_set1_epi8(a);
+    __m128i vb = _mm_set1_epi8(b);
+    while (end - p >= 16)
+    {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+      int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)));
+      if (mask)
+      {
+        return p + __builtin_ctz(mask);
+      }
+      p += 16;
+    }
+    while (p < end && *p != a && *p != b)
+    {
+      ++p;
+    }
+    return p;
+  }
+
+  __attribute__((target("avx2"))) static inline __m256i matchAvx2(const char *p, __m256i va, __m256i vb)
+  {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    return _mm256_or_si256(_mm256_cmpeq_epi8(v, va), _mm256_cmpeq_epi8(v, vb));
+  }
+
+  __attribute__((target("avx2"))) static inline uint64_t maskAvx2(__m256i lo, __m256i hi)
+  {
+    return (uint32_t)_mm256_movemask_epi8(lo) | ((uint64_t)(uint32_t)_mm256_movemask_epi8(hi) << 32);
+  }
+
+  __attribute__((target("avx2"))) static const char *findFirstOf2Avx2(const char *begin, const char *end, char a, char b)
+  {
+    if (end - begin < 64)
+    {
+      return findFirstOf2Sse2(begin, end, a, b);
+    }
+
+    __m256i va = _mm256_set1_epi8(a);
+    __m256i vb = _mm256_set1_epi8(b);
+    const char *p = begin;
+    uint64_t mask = maskAvx2(matchAvx2(p, va, vb), matchAvx2(p + 32, va, vb));
+    if (mask)
+    {
+      return p + __builtin_ctzll(mask);
+    }
+
+    // 之后按 64 字节对齐读，跨 cache line 的非对齐读在长数据上比比较本身还慢；
+    // 一次看 128 字节，四个比较结果合并之后只做一次 movemask
+    p = reinterpret_cast<const char *>((reinterpret_cast<uintptr_t>(p) + 64) & ~(uintptr_t)63);
+    while (end - p >= 128)
+    {
+      __m256i m0 = matchAvx2(p, va, vb);
+      __m256i m1 = matchAvx2(p + 32, va, vb);
+      __m256i m2 = matchAvx2(p + 64, va, vb);
+      __m256i m3 = matchAvx2(p + 96, va, vb);
+      if (_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(m0, m1), _mm256_or_si256(m2, m3))))
+      {
+        mask = maskAvx2(m0, m1);
+        if (mask)
+        {
+          return p + __builtin_ctzll(mask);
+        }
+        return p + 64 + __builtin_ctzll(maskAvx2(m2, m3));
+      }
+      p += 128;
+    }
+    while (end - p >= 32)
+    {
+      uint32_t m = (uint32_t)_mm256_movemask_epi8(matchAvx2(p, va, vb));
+      if (m)
+      {
+        return p + __builtin_ctz(m);
+      }
+      p += 32;
+    }
+
+    // 剩下不到 32 字节，从 end - 32 读一次，和前面重叠的部分已经确认没有命中
+    if (p < end)
+    {
+      const char *q = end - 32;
+      uint32_t m = (uint32_t)_mm256_movemask_epi8(matchAvx2(q, va, vb));
+      return m ? q + __builtin_ctz(m) : end;
+    }
+    return end;
+  }
+
+  static FindFirstOf2Func selectFindFirstOf2()
+  {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+      return findFirstOf2Avx2;
+    }
+    return findFirstOf2Sse2;
+  }
+
+#else
+
+  // 先找 a，再只在 a 之前找 b，两次都是 libc 的向量化 memchr
+  static const char *findFirstOf2Memchr(const char *begin, const char *end, char a, char b)
+  {
+    const char *pa = reinterpret_cast<const char *>(memchr(begin, a, end - begin));
+    if (pa == NULL)
+    {
+      pa = end;
+    }
+    const char *pb = reinterpret_cast<const char *>(memchr(begin, b, pa - begin));
+    return pb ? pb : pa;
+  }
+
+  static FindFirstOf2Func selectFindFirstOf2()
+  {
+    return findFirstOf2Memchr;
+  }
+
+#endif
+
+  static const FindFirstOf2Func g_find_first_of2 = selectFindFirstOf2();
+
+  const char *findFirstOf2(const char *begin, const char *end, char a, char b)
+  {
+    // 大多数时候第一个字节就是要找的，不值得走一次向量比较
+    if (begin < end && (*begin == a || *begin == b))
+    {
+      return begin;
+    }
+    return g_find_first_of2(begin, end, a, b);
+  }
+
+}
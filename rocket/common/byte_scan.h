@@ -0,0 +1,13 @@
+#ifndef ROCKET_COMMON_BYTE_SCAN_H
+#define ROCKET_COMMON_BYTE_SCAN_H
+
+namespace rocket
+{
+
+  // 在 [begin, end) 里找第一个等于 a 或 b 的字节，找不到返回 end。
+  // x86_64 上按 cpu 选 AVX2（对齐之后一次看 128 字节）或 SSE2，其它平台用两次 memchr
+  const char *findFirstOf2(const char *begin, const char *end, char a, char b);
+
+}
+
+#endif
@@ -0,0 +1,170 @@
+#include <time.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include "rocket/common/clock.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define ROCKET_HAS_TSC 1
+#endif
+
+namespace rocket
+{
+
+  static std::atomic<bool> g_tsc_enabled{false};
+  static double g_us_per_tsc_tick = 0;
+  static std::once_flag g_tsc_once;
+
+  // 两次 Update() 之间外推超过这个时间就重新读一次时钟，避免校准误差累积
+  static const int64_t g_max_extrapolate_us = 1000000;
+
+  // 0 表示本线程没有有效的缓存时间
+  static thread_local int64_t t_cached_us = 0;
+  static thread_local uint64_t t_cached_tsc = 0;
+
+  static thread_local time_t t_wall_sec = -1;
+  static thread_local char t_wall_prefix[32];
+  static thread_local size_t t_wall_prefix_len = 0;
+
+  static inline uint64_t readTsc()
+  {
+#ifdef ROCKET_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+  }
+
+  static bool hasInvariantTsc()
+  {
+#ifdef ROCKET_HAS_TSC
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007)
+    {
+      return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    // CPUID.80000007H:EDX[8]，TSC 频率恒定且在深度睡眠时不停
+    return (edx & (1 << 8)) != 0;
+#else
+    return false;
+#endif
+  }
+
+  static void calibrateTsc()
+  {
+    if (!hasInvariantTsc())
+    {
+      return;
+    }
+
+    int64_t begin_us = Clock::MonotonicUs();
+    uint64_t begin_tsc = readTsc();
+    int64_t end_us = begin_us;
+    while (end_us - begin_us < 10000)
+    {
+      end_us = Clock::MonotonicUs();
+    }
+    uint64_t end_tsc = readTsc();
+
+    if (end_tsc <= begin_tsc)
+    {
+      return;
+    }
+    g_us_per_tsc_tick = (double)(end_us - begin_us) / (double)(end_tsc - begin_tsc);
+    g_tsc_enabled.store(true);
+  }
+
+  bool Clock::EnableTsc()
+  {
+    std::call_once(g_tsc_once, calibrateTsc);
+    return g_tsc_enabled.load();
+  }
+
+  bool Clock::IsTscEnabled()
+  {
+    return g_tsc_enabled.load(std::memory_order_relaxed);
+  }
+
+  int64_t Clock::MonotonicUs()
+  {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+  }
+
+  int64_t Clock::Update()
+  {
+    t_cached_us = MonotonicUs();
+    if (IsTscEnabled())
+    {
+      t_cached_tsc = readTsc();
+    }
+    return t_cached_us;
+  }
+
+  int64_t Clock::CachedUs()
+  {
+    if (t_cached_us == 0)
+    {
+      return MonotonicUs();
+    }
+    return t_cached_us;
+  }
+
+  int64_t Clock::FastUs()
+  {
+    if (t_cached_us == 0 || !IsTscEnabled())
+    {
+      return MonotonicUs();
+    }
+
+    uint64_t now_tsc = readTsc();
+    // 线程换核后两个核的 TSC 可能有细微差别，不让时间倒退
+    if (now_tsc <= t_cached_tsc)
+    {
+      return t_cached_us;
+    }
+    int64_t delta = (int64_t)((double)(now_tsc - t_cached_tsc) * g_us_per_tsc_tick);
+    if (delta > g_max_extrapolate_us)
+    {
+      return Update();
+    }
+    return t_cached_us + delta;
+  }
+
+  void Clock::Invalidate()
+  {
+    t_cached_us = 0;
+    t_cached_tsc = 0;
+  }
+
+  std::string Clock::WallTimeString()
+  {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    if (ts.tv_sec != t_wall_sec)
+    {
+      struct tm now_time;
+      localtime_r(&ts.tv_sec, &now_time);
+      t_wall_prefix_len = strftime(t_wall_prefix, sizeof(t_wall_prefix), "%y-%m-%d %H:%M:%S", &now_time);
+      t_wall_sec = ts.tv_sec;
+    }
+
+    char buf[40];
+    memcpy(buf, t_wall_prefix, t_wall_prefix_len);
+    int ms = ts.tv_nsec / 1000000;
+    char *p = buf + t_wall_prefix_len;
+    p[0] = '.';
+    p[1] = '0' + ms / 100;
+    p[2] = '0' + ms / 10 % 10;
+    p[3] = '0' + ms % 10;
+
+    return std::string(buf, t_wall_prefix_len + 4);
+  }
+
+}
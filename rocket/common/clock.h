@@ -0,0 +1,45 @@
+#ifndef ROCKET_COMMON_CLOCK_H
+#define ROCKET_COMMON_CLOCK_H
+
+#include <stdint.h>
+#include <string>
+
+namespace rocket
+{
+
+  /// @brief 时间服务
+  /// 单调时间（us）用于定时器和耗时统计，不受系统时间调整影响；墙上时间只用于日志。
+  /// 每个 EventLoop 在每轮 poll 返回后调用一次 Update() 刷新本线程的缓存时间，
+  /// 同一轮 loop 里的 CachedUs() 不再读时钟；FastUs() 在缓存时间的基础上用 TSC 外推，
+  /// 精度接近 MonotonicUs()，开销只有一条 rdtsc 指令。
+  class Clock
+  {
+  public:
+    // 开启 TSC 快速时钟，只有 CPU 支持 invariant TSC 时才生效，返回是否生效。
+    // 第一次调用时做一次约 10ms 的频率校准，之后重复调用直接返回
+    static bool EnableTsc();
+
+    static bool IsTscEnabled();
+
+    // 直接读 CLOCK_MONOTONIC
+    static int64_t MonotonicUs();
+
+    // 刷新本线程的缓存时间（和 TSC 基准点）并返回
+    static int64_t Update();
+
+    // 本线程最近一次 Update() 的时间；EventLoop 没在运行的线程直接读时钟
+    static int64_t CachedUs();
+
+    // 缓存时间 + TSC 外推；没开启 TSC 或本线程没有缓存时退化为 MonotonicUs()
+    static int64_t FastUs();
+
+    // loop 退出时调用，之后本线程的 CachedUs()/FastUs() 重新直接读时钟
+    static void Invalidate();
+
+    // 当前墙上时间，格式为 23-10-05 14:30:45.123，秒以上部分按秒缓存，每秒只格式化一次
+    static std::string WallTimeString();
+  };
+
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include <tinyxml/tinyxml.h>
 #include "rocket/common/config.h"
+#include "rocket/common/cpu_affinity.h"
 
 #define READ_XML_NODE(name, parent)                                         \
   TiXmlElement *name##_node = parent->FirstChildElement(#name);             \
@@ -18,6 +19,15 @@
   }                                                                              \
   std::string name##_str = std::string(name##_node->GetText());
 
+// 可选配置项，节点不存在时使用默认值
+#define READ_OPTIONAL_STR_FROM_XML_NODE(name, parent, default_value) \
+  std::string name##_str = default_value;                           \
+  TiXmlElement *name##_node = parent->FirstChildElement(#name);     \
+  if (name##_node && name##_node->GetText())                        \
+  {                                                                 \
+    name##_str = std::string(name##_node->GetText());               \
+  }
+
 namespace rocket
 {
 
@@ -93,6 +103,91 @@ namespace rocket
     m_port = std::atoi(port_str.c_str());
     m_io_threads = std::atoi(io_threads_str.c_str());
 
+    // LT: 水平触发, ET: 边缘触发, ONESHOT / ET_ONESHOT: 每次触发后需要重新打开监听
+    READ_OPTIONAL_STR_FROM_XML_NODE(trigger_mode, server_node, "LT");
+    m_edge_triggered = (trigger_mode_str == "ET" || trigger_mode_str == "ET_ONESHOT");
+    m_one_shot = (trigger_mode_str == "ONESHOT" || trigger_mode_str == "ET_ONESHOT");
+
+    READ_OPTIONAL_STR_FROM_XML_NODE(poller, server_node, "epoll");
+    m_poller = poller_str;
+
+    // monotonic: 只用 clock_gettime, tsc: CPU 支持 invariant TSC 时用 TSC 外推
+    READ_OPTIONAL_STR_FROM_XML_NODE(clock, server_node, "monotonic");
+    m_tsc_clock = (clock_str == "tsc");
+
+    READ_OPTIONAL_STR_FROM_XML_NODE(idle_timeout_ms, server_node, "0");
+    READ_OPTIONAL_STR_FROM_XML_NODE(heartbeat_interval_ms, server_node, "0");
+    m_idle_timeout_ms = std::atoi(idle_timeout_ms_str.c_str());
+    m_heartbeat_interval_ms = std::atoi(heartbeat_interval_ms_str.c_str());
+
+    READ_OPTIONAL_STR_FROM_XML_NODE(max_accept_per_wakeup, server_node, "64");
+    m_max_accept_per_wakeup = std::atoi(max_accept_per_wakeup_str.c_str());
+
+    READ_OPTIONAL_STR_FROM_XML_NODE(listen_backlog, server_node, "1000");
+    m_listen_backlog = std::atoi(listen_backlog_str.c_str());
+
+    READ_OPTIONAL_STR_FROM_XML_NODE(max_frame_size, server_node, "67108864");
+    m_max_frame_size = std::atoi(max_frame_size_str.c_str());
+
+    READ_OPTIONAL_STR_FROM_XML_NODE(tinypb_v2, server_node, "1");
+    m_tinypb_v2 = std::atoi(tinypb_v2_str.c_str()) != 0;
+
+    TiXmlElement *admission_node = server_node->FirstChildElement("admission");
+    if (admission_node)
+    {
+      READ_OPTIONAL_STR_FROM_XML_NODE(max_connections, admission_node, "0");
+      READ_OPTIONAL_STR_FROM_XML_NODE(max_connections_per_thread, admission_node, "0");
+      READ_OPTIONAL_STR_FROM_XML_NODE(max_connections_per_ip, admission_node, "0");
+      READ_OPTIONAL_STR_FROM_XML_NODE(over_limit_action, admission_node, "reject");
+      m_max_connections = std::atoi(max_connections_str.c_str());
+      m_max_connections_per_thread = std::atoi(max_connections_per_thread_str.c_str());
+      m_max_connections_per_ip = std::atoi(max_connections_per_ip_str.c_str());
+      m_over_limit_action = over_limit_action_str;
+
+      printf("ADMISSION -- MAX_CONNECTIONS[%d], PER_THREAD[%d], PER_IP[%d], OVER_LIMIT_ACTION[%s]\n",
+             m_max_connections, m_max_connections_per_thread, m_max_connections_per_ip, m_over_limit_action.c_str());
+    }
+
+    TiXmlElement *io_thread_group_node = server_node->FirstChildElement("io_thread_group");
+    if (io_thread_group_node)
+    {
+      READ_OPTIONAL_STR_FROM_XML_NODE(busy_poll_us, io_thread_group_node, "0");
+      READ_OPTIONAL_STR_FROM_XML_NODE(busy_poll_density, io_thread_group_node, "0.5");
+      READ_OPTIONAL_STR_FROM_XML_NODE(so_busy_poll_us, io_thread_group_node, "0");
+      READ_OPTIONAL_STR_FROM_XML_NODE(placement, io_thread_group_node, "round_robin");
+      READ_OPTIONAL_STR_FROM_XML_NODE(reuse_port, io_thread_group_node, "0");
+      READ_OPTIONAL_STR_FROM_XML_NODE(reuse_port_cbpf, io_thread_group_node, "0");
+      m_busy_poll_us = std::atoi(busy_poll_us_str.c_str());
+      m_busy_poll_density = std::atof(busy_poll_density_str.c_str());
+      m_so_busy_poll_us = std::atoi(so_busy_poll_us_str.c_str());
+      m_placement = placement_str;
+      m_reuse_port = (reuse_port_str == "1" || reuse_port_str == "true");
+      m_reuse_port_cbpf = (reuse_port_cbpf_str == "1" || reuse_port_cbpf_str == "true");
+    }
+
+    TiXmlElement *cpu_affinity_node = server_node->FirstChildElement("cpu_affinity");
+    if (cpu_affinity_node)
+    {
+      READ_OPTIONAL_STR_FROM_XML_NODE(io_threads, cpu_affinity_node, "");
+      READ_OPTIONAL_STR_FROM_XML_NODE(acceptor, cpu_affinity_node, "");
+      READ_OPTIONAL_STR_FROM_XML_NODE(logger, cpu_affinity_node, "");
+      READ_OPTIONAL_STR_FROM_XML_NODE(numa_local, cpu_affinity_node, "0");
+      if (!parseCpuSets(io_threads_str, m_io_thread_cpus) || !parseCpuList(acceptor_str, m_acceptor_cpus) || !parseCpuList(logger_str, m_logger_cpus))
+      {
+        printf("Start rocket server error, invalid cpu list in [cpu_affinity]\n");
+        exit(0);
+      }
+      m_numa_local = (numa_local_str == "1" || numa_local_str == "true");
+
+      std::string io_cpus;
+      for (size_t i = 0; i < m_io_thread_cpus.size(); ++i)
+      {
+        io_cpus += (i == 0 ? "" : ";") + cpuListToString(m_io_thread_cpus[i]);
+      }
+      printf("CPU_AFFINITY -- IO_THREADS[%s], ACCEPTOR[%s], LOGGER[%s], NUMA_LOCAL[%d]\n",
+             io_cpus.c_str(), cpuListToString(m_acceptor_cpus).c_str(), cpuListToString(m_logger_cpus).c_str(), m_numa_local);
+    }
+
     TiXmlElement *stubs_node = root_node->FirstChildElement("stubs");
 
     if (stubs_node)
@@ -111,7 +206,8 @@ namespace rocket
       }
     }
 
-    printf("Server -- PORT[%d], IO Threads[%d]\n", m_port, m_io_threads);
+    printf("Server -- PORT[%d], IO Threads[%d], TRIGGER_MODE[%s], POLLER[%s], CLOCK[%s], BUSY_POLL[%d us, density %.2f], SO_BUSY_POLL[%d us], PLACEMENT[%s], REUSE_PORT[%d, cbpf %d], MAX_ACCEPT_PER_WAKEUP[%d], LISTEN_BACKLOG[%d], MAX_FRAME_SIZE[%d B], TINYPB_V2[%d], IDLE_TIMEOUT[%d ms], HEARTBEAT[%d ms]\n",
+           m_port, m_io_threads, trigger_mode_str.c_str(), m_poller.c_str(), clock_str.c_str(), m_busy_poll_us, m_busy_poll_density, m_so_busy_poll_us, m_placement.c_str(), m_reuse_port, m_reuse_port_cbpf, m_max_accept_per_wakeup, m_listen_backlog, m_max_frame_size, m_tinypb_v2, m_idle_timeout_ms, m_heartbeat_interval_ms);
   }
 
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define ROCKET_COMMON_CONFIG_H
 
 #include <map>
+#include <vector>
 #include <tinyxml/tinyxml.h>
 #include "rocket/net/tcp/net_addr.h"
 
@@ -38,6 +39,39 @@ namespace rocket
     int m_port{0};
     int m_io_threads{0};
 
+    bool m_edge_triggered{false}; // 连接 fd 使用 EPOLLET
+    bool m_one_shot{false};       // 连接 fd 使用 EPOLLONESHOT
+
+    std::string m_poller{"epoll"}; // EventLoop 的 IO 多路复用后端: epoll / io_uring
+
+    bool m_tsc_clock{false}; // 耗时统计和任务预算用 TSC 外推的快速时钟
+
+    // IO 线程组的忙轮询，见 <server><io_thread_group>
+    int m_busy_poll_us{0};
+    double m_busy_poll_density{0.5};
+    int m_so_busy_poll_us{0}; // 连接 fd 的 SO_BUSY_POLL，0 表示不设置
+    std::string m_placement{"round_robin"}; // 新连接的放置策略，见 PlacementPolicy::CreatePlacementPolicy
+    int m_idle_timeout_ms{0};       // 读写都空闲超过这个时间的连接被关闭，0 表示不检测
+    int m_heartbeat_interval_ms{0}; // 对端这么久没有发来数据时发送心跳 ping，0 表示不发
+    int m_max_accept_per_wakeup{64}; // 监听 fd 每次可读时最多 accept 的连接数，<= 0 表示不限制
+    bool m_reuse_port{false};      // 每个 IO 线程一个 SO_REUSEPORT 的监听 socket，主线程不再 accept
+    bool m_reuse_port_cbpf{false}; // reuseport 模式下按 cpu 选 socket
+    int m_listen_backlog{1000};    // listen 的 backlog
+    int m_max_frame_size{64 * 1024 * 1024}; // TinyPB 单个包的最大长度，0 表示不限制
+    bool m_tinypb_v2{true};        // 和同样支持的对端协商使用 TinyPB v2 帧格式
+
+    // 连接准入控制，见 <server><admission>，0 表示不限制
+    int m_max_connections{0};
+    int m_max_connections_per_thread{0};
+    int m_max_connections_per_ip{0};
+    std::string m_over_limit_action{"reject"}; // reject / close / pause
+
+    // 绑核，见 <server><cpu_affinity>，为空表示不绑定
+    std::vector<std::vector<int>> m_io_thread_cpus; // 第 i 个 IO 线程使用第 i % size 组
+    std::vector<int> m_acceptor_cpus;
+    std::vector<int> m_logger_cpus;
+    bool m_numa_local{false}; // 绑核后的线程内存优先在本 NUMA 节点分配
+
     TiXmlDocument *m_xml_document{NULL};
 
     std::map<std::string, RpcStub> m_rpc_stubs;
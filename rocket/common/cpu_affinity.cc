@@ -0,0 +1,141 @@
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include "rocket/common/cpu_affinity.h"
+
+namespace rocket
+{
+
+  // linux/mempolicy.h 中的 MPOL_LOCAL，内核 3.8 之后支持
+  static const int g_mpol_local = 4;
+
+  static bool parseCpuNumber(const std::string &str, int &cpu)
+  {
+    if (str.empty() || str.size() > 6 || str.find_first_not_of("0123456789") != std::string::npos)
+    {
+      return false;
+    }
+    cpu = std::atoi(str.c_str());
+    return cpu < CPU_SETSIZE;
+  }
+
+  bool parseCpuList(const std::string &str, std::vector<int> &cpus)
+  {
+    cpus.clear();
+    size_t begin = 0;
+    while (begin <= str.size())
+    {
+      size_t end = str.find(',', begin);
+      if (end == std::string::npos)
+      {
+        end = str.size();
+      }
+      std::string item = str.substr(begin, end - begin);
+      item.erase(0, item.find_first_not_of(" \t\n"));
+      item.erase(item.find_last_not_of(" \t\n") + 1);
+
+      if (!item.empty())
+      {
+        size_t dash = item.find('-');
+        int first = 0;
+        int last = 0;
+        if (dash == std::string::npos)
+        {
+          if (!parseCpuNumber(item, first))
+          {
+            return false;
+          }
+          last = first;
+        }
+        else if (!parseCpuNumber(item.substr(0, dash), first) || !parseCpuNumber(item.substr(dash + 1), last) || first > last)
+        {
+          return false;
+        }
+
+        for (int cpu = first; cpu <= last; ++cpu)
+        {
+          cpus.push_back(cpu);
+        }
+      }
+      begin = end + 1;
+    }
+    return true;
+  }
+
+  bool parseCpuSets(const std::string &str, std::vector<std::vector<int>> &cpu_sets)
+  {
+    cpu_sets.clear();
+    size_t begin = 0;
+    while (begin <= str.size())
+    {
+      size_t end = str.find(';', begin);
+      if (end == std::string::npos)
+      {
+        end = str.size();
+      }
+      std::vector<int> cpus;
+      if (!parseCpuList(str.substr(begin, end - begin), cpus))
+      {
+        return false;
+      }
+      if (!cpus.empty())
+      {
+        cpu_sets.push_back(cpus);
+      }
+      begin = end + 1;
+    }
+    return true;
+  }
+
+  std::string cpuListToString(const std::vector<int> &cpus)
+  {
+    std::string re;
+    for (size_t i = 0; i < cpus.size(); ++i)
+    {
+      if (i != 0)
+      {
+        re += ",";
+      }
+      re += std::to_string(cpus[i]);
+    }
+    return re;
+  }
+
+  bool bindCurrentThreadToCpus(const std::vector<int> &cpus)
+  {
+    if (cpus.empty())
+    {
+      return true;
+    }
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (size_t i = 0; i < cpus.size(); ++i)
+    {
+      CPU_SET(cpus[i], &cpu_set);
+    }
+
+    int rt = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (rt != 0)
+    {
+      errno = rt;
+      return false;
+    }
+    return true;
+  }
+
+  bool setNumaLocalPolicy()
+  {
+#ifdef SYS_set_mempolicy
+    return syscall(SYS_set_mempolicy, g_mpol_local, NULL, 0) == 0;
+#else
+    errno = ENOSYS;
+    return false;
+#endif
+  }
+
+}
@@ -0,0 +1,27 @@
+#ifndef ROCKET_COMMON_CPU_AFFINITY_H
+#define ROCKET_COMMON_CPU_AFFINITY_H
+
+#include <string>
+#include <vector>
+
+namespace rocket
+{
+
+  // 解析 cpu 列表，格式和 taskset -c 一样，例如 "0-3,8,10-11"，格式错误时返回 false
+  bool parseCpuList(const std::string &str, std::vector<int> &cpus);
+
+  // 解析多组 cpu 列表，组之间用 ';' 分隔，例如 "2-3;4-5"
+  bool parseCpuSets(const std::string &str, std::vector<std::vector<int>> &cpu_sets);
+
+  std::string cpuListToString(const std::vector<int> &cpus);
+
+  // 把当前线程绑定到 cpus 上，cpus 为空时什么都不做
+  bool bindCurrentThreadToCpus(const std::vector<int> &cpus);
+
+  // 当前线程之后的内存分配优先放在当前 cpu 所在的 NUMA 节点（MPOL_LOCAL），
+  // 配合绑核使用，进程被 numactl --interleave 等方式启动时也能保证本地分配
+  bool setNumaLocalPolicy();
+
+}
+
+#endif
@@ -0,0 +1,253 @@
+#include <string.h>
+#include "rocket/common/crc32c.h"
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#include <wmmintrin.h>
+#define ROCKET_CRC32C_X86 1
+#elif defined(__aarch64__) && defined(__linux__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#define ROCKET_CRC32C_ARM 1
+#endif
+
+namespace rocket
+{
+
+  // 实现按 cpu 在启动时选一次：
+  // table     逐字节查表，最早的实现，留作基准
+  // slicing8  8 张表一次处理 8 字节，没有硬件指令时使用
+  // sse42     crc32 指令一次 8 字节，单条依赖链
+  // pclmul    crc32 指令三路并行处理三个相邻的块，再用 pclmulqdq 把前两块的 crc 移位后合并，长数据接近指令吞吐
+  // armv8     ARMv8 的 crc32c 指令
+
+  static const uint32_t g_crc32c_poly = 0x82F63B78; // 0x1EDC6F41 的反转
+
+  struct Crc32cTable
+  {
+    uint32_t m_table[8][256];
+
+    Crc32cTable()
+    {
+      for (uint32_t i = 0; i < 256; ++i)
+      {
+        uint32_t crc = i;
+        for (int j = 0; j < 8; ++j)
+        {
+          crc = (crc & 1) ? (crc >> 1) ^ g_crc32c_poly : crc >> 1;
+        }
+        m_table[0][i] = crc;
+      }
+      // m_table[k][i] 是字节 i 后面再跟 k 个 0 字节的 crc
+      for (uint32_t i = 0; i < 256; ++i)
+      {
+        for (int k = 1; k < 8; ++k)
+        {
+          m_table[k][i] = m_table[0][m_table[k - 1][i] & 0xff] ^ (m_table[k - 1][i] >> 8);
+        }
+      }
+    }
+  };
+
+  static const Crc32cTable g_crc32c_table;
+
+  // 下面的实现都不做首尾取反，crc 是寄存器里的原始值
+
+  static uint32_t crc32cTable(uint32_t crc, const char *data, size_t len)
+  {
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < len; ++i)
+    {
+      crc = g_crc32c_table.m_table[0][(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+  }
+
+  static uint32_t crc32cSlicing8(uint32_t crc, const char *data, size_t len)
+  {
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(data);
+    const uint32_t(*t)[256] = g_crc32c_table.m_table;
+    while (len >= 8)
+    {
+      // 按小端组装，和逐字节的顺序一致，不依赖主机字节序
+      uint32_t lo = crc ^ ((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+      crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+            t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+      p += 8;
+      len -= 8;
+    }
+    return crc32cTable(crc, reinterpret_cast<const char *>(p), len);
+  }
+
+#ifdef ROCKET_CRC32C_X86
+
+  __attribute__((target("sse4.2"))) static uint32_t crc32cSse42(uint32_t crc, const char *data, size_t len)
+  {
+    uint64_t crc64 = crc;
+    while (len >= 8)
+    {
+      uint64_t value;
+      memcpy(&value, data, sizeof(value));
+      crc64 = _mm_crc32_u64(crc64, value);
+      data += 8;
+      len -= 8;
+    }
+    crc = (uint32_t)crc64;
+    while (len > 0)
+    {
+      crc = _mm_crc32_u8(crc, (uint8_t)*data);
+      ++data;
+      --len;
+    }
+    return crc;
+  }
+
+  // 反转表示下的多项式乘法 a * b mod P，0x80000000 表示 1
+  static uint32_t multModP(uint32_t a, uint32_t b)
+  {
+    uint32_t m = 1u << 31;
+    uint32_t p = 0;
+    while (m)
+    {
+      if (a & m)
+      {
+        p ^= b;
+      }
+      m >>= 1;
+      b = (b & 1) ? (b >> 1) ^ g_crc32c_poly : b >> 1;
+    }
+    return p;
+  }
+
+  // x^n mod P
+  static uint32_t xPowModP(uint64_t n)
+  {
+    uint32_t result = 0x80000000;
+    uint32_t base = 0x40000000;
+    while (n)
+    {
+      if (n & 1)
+      {
+        result = multModP(result, base);
+      }
+      base = multModP(base, base);
+      n >>= 1;
+    }
+    return result;
+  }
+
+  static const size_t PCLMUL_BLOCK = 256; // 三路并行时每一路的长度
+
+  // 把 crc 移过 n 个 0 字节等价于乘 x^(8n)。pclmul 的积按反转表示多出一个 x，crc32 指令再乘 x^32 并取模，
+  // 所以常数取 x^(8n - 33)
+  struct Crc32cShift
+  {
+    uint64_t m_one_block;
+    uint64_t m_two_blocks;
+
+    Crc32cShift() : m_one_block(xPowModP(PCLMUL_BLOCK * 8 - 33)), m_two_blocks(xPowModP(PCLMUL_BLOCK * 16 - 33))
+    {
+    }
+  };
+
+  static const Crc32cShift g_crc32c_shift;
+
+  __attribute__((target("sse4.2,pclmul"))) static uint32_t shiftCrc(uint32_t crc, uint64_t k)
+  {
+    __m128i product = _mm_clmulepi64_si128(_mm_cvtsi32_si128(crc), _mm_cvtsi64_si128(k), 0x00);
+    return (uint32_t)_mm_crc32_u64(0, _mm_cvtsi128_si64(product));
+  }
+
+  __attribute__((target("sse4.2,pclmul"))) static uint32_t crc32cPclmul(uint32_t crc, const char *data, size_t len)
+  {
+    // crc32 指令延迟 3 个周期、吞吐 1 个周期，三条独立的依赖链正好把流水线填满
+    while (len >= PCLMUL_BLOCK * 3)
+    {
+      uint64_t crc0 = crc;
+      uint64_t crc1 = 0;
+      uint64_t crc2 = 0;
+      const char *p0 = data;
+      const char *p1 = data + PCLMUL_BLOCK;
+      const char *p2 = data + PCLMUL_BLOCK * 2;
+      for (size_t i = 0; i < PCLMUL_BLOCK; i += 8)
+      {
+        uint64_t v0, v1, v2;
+        memcpy(&v0, p0 + i, sizeof(v0));
+        memcpy(&v1, p1 + i, sizeof(v1));
+        memcpy(&v2, p2 + i, sizeof(v2));
+        crc0 = _mm_crc32_u64(crc0, v0);
+        crc1 = _mm_crc32_u64(crc1, v1);
+        crc2 = _mm_crc32_u64(crc2, v2);
+      }
+      crc = shiftCrc((uint32_t)crc0, g_crc32c_shift.m_two_blocks) ^ shiftCrc((uint32_t)crc1, g_crc32c_shift.m_one_block) ^ (uint32_t)crc2;
+      data += PCLMUL_BLOCK * 3;
+      len -= PCLMUL_BLOCK * 3;
+    }
+    return crc32cSse42(crc, data, len);
+  }
+
+#endif
+
+#ifdef ROCKET_CRC32C_ARM
+
+  __attribute__((target("+crc"))) static uint32_t crc32cArmv8(uint32_t crc, const char *data, size_t len)
+  {
+    while (len >= 8)
+    {
+      uint64_t value;
+      memcpy(&value, data, sizeof(value));
+      crc = __crc32cd(crc, value);
+      data += 8;
+      len -= 8;
+    }
+    while (len > 0)
+    {
+      crc = __crc32cb(crc, (uint8_t)*data);
+      ++data;
+      --len;
+    }
+    return crc;
+  }
+
+#endif
+
+  std::vector<Crc32cImpl> getCrc32cImpls()
+  {
+    std::vector<Crc32cImpl> impls;
+    impls.push_back(Crc32cImpl{"table", crc32cTable});
+    impls.push_back(Crc32cImpl{"slicing8", crc32cSlicing8});
+#ifdef ROCKET_CRC32C_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+      impls.push_back(Crc32cImpl{"sse42", crc32cSse42});
+      if (__builtin_cpu_supports("pclmul"))
+      {
+        impls.push_back(Crc32cImpl{"pclmul", crc32cPclmul});
+      }
+    }
+#endif
+#ifdef ROCKET_CRC32C_ARM
+    if (getauxval(AT_HWCAP) & HWCAP_CRC32)
+    {
+      impls.push_back(Crc32cImpl{"armv8", crc32cArmv8});
+    }
+#endif
+    return impls;
+  }
+
+  // 静态初始化时选定，和上面的表在同一个编译单元，初始化顺序有保证
+  static const Crc32cExtendFunc g_crc32c_extend = getCrc32cImpls().back().m_func;
+
+  uint32_t crc32cExtend(uint32_t crc, const char *data, size_t len)
+  {
+    return ~g_crc32c_extend(~crc, data, len);
+  }
+
+  uint32_t crc32c(const char *data, size_t len)
+  {
+    return crc32cExtend(0, data, len);
+  }
+
+}
@@ -0,0 +1,31 @@
+#ifndef ROCKET_COMMON_CRC32C_H
+#define ROCKET_COMMON_CRC32C_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace rocket
+{
+
+  // CRC32C (Castagnoli)，TinyPB v2 的校验和
+  uint32_t crc32c(const char *data, size_t len);
+
+  // 在已有的 crc 后面接着算，crc32cExtend(crc32c(a), b) == crc32c(a + b)
+  uint32_t crc32cExtend(uint32_t crc, const char *data, size_t len);
+
+  typedef uint32_t (*Crc32cExtendFunc)(uint32_t crc, const char *data, size_t len);
+
+  struct Crc32cImpl
+  {
+    const char *m_name;
+    Crc32cExtendFunc m_func;
+  };
+
+  // 当前 cpu 上可用的所有实现，从慢到快，最后一个就是 crc32cExtend 使用的。给测试和基准测试用，
+  // m_func 不做首尾取反：crc32cExtend(crc, data, len) == ~m_func(~crc, data, len)
+  std::vector<Crc32cImpl> getCrc32cImpls();
+
+}
+
+#endif
@@ -21,5 +21,6 @@ const int ERROR_METHOD_NOT_FOUND = SYS_ERROR_PREFIX(0009);   // method 不存在
 const int ERROR_PARSE_SERVICE_NAME = SYS_ERROR_PREFIX(0010); // service name 解析失败
 const int ERROR_RPC_CHANNEL_INIT = SYS_ERROR_PREFIX(0011);   // rpc channel 初始化失败
 const int ERROR_RPC_PEER_ADDR = SYS_ERROR_PREFIX(0012);      // rpc 调用时候对端地址异常
+const int ERROR_SERVER_OVERLOADED = SYS_ERROR_PREFIX(0013);  // 服务端连接数超限，拒绝新连接
 
 #endif
\ No newline at end of file
@@ -3,8 +3,12 @@
 #include <stdio.h>
 #include <assert.h>
 #include <signal.h>
+#include <errno.h>
+#include <string.h>
 #include "rocket/common/log.h"
 #include "rocket/common/util.h"
+#include "rocket/common/clock.h"
+#include "rocket/common/cpu_affinity.h"
 #include "rocket/common/config.h"
 #include "rocket/net/eventloop.h"
 #include "rocket/common/run_time.h"
@@ -84,6 +88,7 @@ namespace rocket
     }
     //构建一个定时任务，周期执行，同时绑定回调
     m_timer_event = std::make_shared<TimerEvent>(Config::GetGlobalConfig()->m_log_sync_inteval, true, std::bind(&Logger::syncLoop, this));
+    m_timer_event->setPriority(TaskPriorityBackground);
     //将定时事件挂载到当前loop当中
     EventLoop::GetCurrentEventLoop()->addTimerEvent(m_timer_event);
 
@@ -182,19 +187,8 @@ namespace rocket
   /// @return 格式化后的字符串
   std::string LogEvent::toString()
   {
-    //获取当前时间，并格式化为23-10-05 14:30:45.123这样的形式
-    struct timeval now_time;
-
-    gettimeofday(&now_time, nullptr);
-
-    struct tm now_time_t;
-    localtime_r(&(now_time.tv_sec), &now_time_t);
-
-    char buf[128];
-    strftime(&buf[0], 128, "%y-%m-%d %H:%M:%S", &now_time_t);
-    std::string time_str(buf);
-    int ms = now_time.tv_usec / 1000;
-    time_str = time_str + "." + std::to_string(ms);
+    //获取当前时间，并格式化为23-10-05 14:30:45.123这样的形式，秒以上部分每秒只格式化一次
+    std::string time_str = Clock::WallTimeString();
 
     //获取当前进程ID和线程ID
     m_pid = getPid();
@@ -278,6 +272,12 @@ namespace rocket
 
     AsyncLogger *logger = reinterpret_cast<AsyncLogger *>(arg);
 
+    // 日志线程绑到单独的核上，不和 IO 线程抢 cpu；这里不能打日志，日志线程还没准备好
+    if (Config::GetGlobalConfig() && !bindCurrentThreadToCpus(Config::GetGlobalConfig()->m_logger_cpus))
+    {
+      printf("async logger bind to cpus [%s] error, errno=%d, error=%s\n", cpuListToString(Config::GetGlobalConfig()->m_logger_cpus).c_str(), errno, strerror(errno));
+    }
+
     //初始化条件变量
     assert(pthread_cond_init(&logger->m_condtion, NULL) == 0);
 
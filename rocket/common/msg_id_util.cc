@@ -1,5 +1,6 @@
 #include <fcntl.h>
 #include <unistd.h>
+#include <stdint.h>
 #include <sys/stat.h>
 #include "rocket/common/msg_id_util.h"
 #include "rocket/common/log.h"
@@ -7,52 +8,36 @@
 namespace rocket
 {
 
-  static int g_msg_id_length = 20;
+  // msg_id 是首位不为 0 的 19 位十进制数，正好能放进 uint64，TinyPB v2 按 8 字节整数发送。
+  // 每个线程从一个随机起点开始递增，到上限后重新取随机起点
+  static const uint64_t g_min_msg_id = 1000000000000000000ULL;
+  static const uint64_t g_max_msg_id = 9999999999999999999ULL;
   static int g_random_fd = -1;
 
-  static thread_local std::string t_msg_id_no;
-  static thread_local std::string t_max_msg_id_no;
+  static thread_local uint64_t t_msg_id_no = 0;
 
   std::string MsgIDUtil::GenMsgID()
   {
-    if (t_msg_id_no.empty() || t_msg_id_no == t_max_msg_id_no)
+    if (t_msg_id_no == 0 || t_msg_id_no >= g_max_msg_id)
     {
       if (g_random_fd == -1)
       {
         g_random_fd = open("/dev/urandom", O_RDONLY);
       }
-      std::string res(g_msg_id_length, 0);
-      if ((read(g_random_fd, &res[0], g_msg_id_length)) != g_msg_id_length)
+      uint64_t random = 0;
+      if (read(g_random_fd, &random, sizeof(random)) != sizeof(random))
       {
         ERRORLOG("read form /dev/urandom error");
         return "";
       }
-      for (int i = 0; i < g_msg_id_length; ++i)
-      {
-        uint8_t x = ((uint8_t)(res[i])) % 10;
-        res[i] = x + '0';
-        t_max_msg_id_no += "9";
-      }
-      t_msg_id_no = res;
+      t_msg_id_no = g_min_msg_id + random % (g_max_msg_id - g_min_msg_id);
     }
     else
     {
-      size_t i = t_msg_id_no.length() - 1;
-      while (t_msg_id_no[i] == '9' && i >= 0)
-      {
-        i--;
-      }
-      if (i >= 0)
-      {
-        t_msg_id_no[i] += 1;
-        for (size_t j = i + 1; j < t_msg_id_no.length(); ++j)
-        {
-          t_msg_id_no[j] = '0';
-        }
-      }
+      ++t_msg_id_no;
     }
 
-    return t_msg_id_no;
+    return std::to_string((unsigned long long)t_msg_id_no);
   }
 
 }
@@ -19,8 +19,7 @@ namespace rocket
 
     ~ScopeMutex()
     {
-      m_mutex.unlock();
-      m_is_lock = false;
+      unlock();
     }
 
     void lock()
@@ -28,14 +27,17 @@ namespace rocket
       if (!m_is_lock)
       {
         m_mutex.lock();
+        m_is_lock = true;
       }
     }
 
+    // 手动解锁后析构时不能再解锁一次，否则会释放掉其它线程持有的锁
     void unlock()
     {
       if (m_is_lock)
       {
         m_mutex.unlock();
+        m_is_lock = false;
       }
     }
 
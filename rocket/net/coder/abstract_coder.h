@@ -3,6 +3,7 @@
 
 #include <vector>
 #include "rocket/net/tcp/tcp_buffer.h"
+#include "rocket/net/tcp/tcp_output_queue.h"
 #include "rocket/net/coder/abstract_protocol.h"
 
 namespace rocket
@@ -14,6 +15,14 @@ namespace rocket
     // 将 message 对象转化为字节流，写入到 buffer
     virtual void encode(std::vector<AbstractProtocol::s_ptr> &messages, TcpBuffer::s_ptr out_buffer) = 0;
 
+    // 将 message 对象编码进发送队列，大块的负载可以只引用不拷贝；默认先编码到临时 buffer 再整体拷贝
+    virtual void encode(std::vector<AbstractProtocol::s_ptr> &messages, TcpOutputQueue::s_ptr out_queue)
+    {
+      TcpBuffer::s_ptr buffer = std::make_shared<TcpBuffer>(128);
+      encode(messages, buffer);
+      out_queue->append(buffer->readPtr(), buffer->readAble());
+    }
+
     // 将 buffer 里面的字节流转换为 message 对象
     virtual void decode(std::vector<AbstractProtocol::s_ptr> &out_messages, TcpBuffer::s_ptr buffer) = 0;
 
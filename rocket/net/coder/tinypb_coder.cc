@@ -5,152 +5,409 @@
 #include "rocket/net/coder/tinypb_protocol.h"
 #include "rocket/common/util.h"
 #include "rocket/common/log.h"
+#include "rocket/common/config.h"
+#include "rocket/common/crc32c.h"
+#include "rocket/common/byte_scan.h"
 
 namespace rocket
 {
 
+  static void appendInt32(std::string &out, int32_t value)
+  {
+    int32_t value_net = htonl(value);
+    out.append(reinterpret_cast<const char *>(&value_net), sizeof(value_net));
+  }
+
+  static void appendUInt64(std::string &out, uint64_t value)
+  {
+    char bytes[sizeof(uint64_t)];
+    for (int i = sizeof(uint64_t) - 1; i >= 0; --i)
+    {
+      bytes[i] = (char)(value & 0xff);
+      value >>= 8;
+    }
+    out.append(bytes, sizeof(bytes));
+  }
+
+  static void appendVarint(std::string &out, uint64_t value)
+  {
+    while (value >= 0x80)
+    {
+      out.push_back((char)(value | 0x80));
+      value >>= 7;
+    }
+    out.push_back((char)value);
+  }
+
+  static void appendString(std::string &out, const std::string &value)
+  {
+    appendVarint(out, value.length());
+    out.append(value);
+  }
+
+  // msg_id 是不超过 19 位、没有多余前导 0 的十进制数时可以按 8 字节整数发送，解码后还原成同一个字符串
+  static bool getNumericMsgId(const std::string &msg_id, uint64_t &value)
+  {
+    if (msg_id.empty() || msg_id.length() > 19 || (msg_id[0] == '0' && msg_id.length() > 1))
+    {
+      return false;
+    }
+    value = 0;
+    for (size_t i = 0; i < msg_id.length(); ++i)
+    {
+      if (msg_id[i] < '0' || msg_id[i] > '9')
+      {
+        return false;
+      }
+      value = value * 10 + (msg_id[i] - '0');
+    }
+    return true;
+  }
+
   // 将 message 对象转化为字节流，写入到 buffer
   void TinyPBCoder::encode(std::vector<AbstractProtocol::s_ptr> &messages, TcpBuffer::s_ptr out_buffer)
   {
+    std::string header;
+    std::string tail;
     for (auto &i : messages)
     {
       std::shared_ptr<TinyPBProtocol> msg = std::dynamic_pointer_cast<TinyPBProtocol>(i);
-      int len = 0;
-      const char *buf = encodeTinyPB(msg, len);
-      if (buf != NULL && len != 0)
+      // 转发解码得到的消息时，pb_data 还在接收缓冲区里，先拷出来
+      msg->detach();
+      header.clear();
+      tail.clear();
+      if (m_enable_v2 && m_peer_v2)
       {
-        out_buffer->writeToBuffer(buf, len);
+        encodeHeaderV2(msg, header);
       }
-      if (buf)
+      else
       {
-        free((void *)buf);
-        buf = NULL;
+        encodeHeader(msg, header);
       }
+      encodeTail(msg, tail);
+
+      out_buffer->ensureWriteAble(msg->m_pk_len);
+      out_buffer->writeToBuffer(header.data(), header.length());
+      out_buffer->writeToBuffer(msg->m_pb_data.data(), msg->m_pb_data.length());
+      out_buffer->writeToBuffer(tail.data(), tail.length());
+    }
+  }
+
+  void TinyPBCoder::encode(std::vector<AbstractProtocol::s_ptr> &messages, TcpOutputQueue::s_ptr out_queue)
+  {
+    std::string header;
+    std::string tail;
+    for (auto &i : messages)
+    {
+      std::shared_ptr<TinyPBProtocol> msg = std::dynamic_pointer_cast<TinyPBProtocol>(i);
+      // 转发解码得到的消息时，pb_data 还在接收缓冲区里，先拷出来
+      msg->detach();
+      header.clear();
+      tail.clear();
+      if (m_enable_v2 && m_peer_v2)
+      {
+        encodeHeaderV2(msg, header);
+      }
+      else
+      {
+        encodeHeader(msg, header);
+      }
+      encodeTail(msg, tail);
+
+      // 帧头和上一帧的帧尾在队列里合并成一个分段，pb_data 由 message 持有
+      out_queue->append(header.data(), header.length());
+      out_queue->appendRef(msg->m_pb_data.data(), msg->m_pb_data.length(), msg);
+      out_queue->append(tail.data(), tail.length());
+    }
+  }
+
+  TinyPBCoder::TinyPBCoder()
+  {
+    if (Config::GetGlobalConfig())
+    {
+      m_max_frame_size = Config::GetGlobalConfig()->m_max_frame_size;
+      m_enable_v2 = Config::GetGlobalConfig()->m_tinypb_v2;
     }
   }
 
+  TinyPBCoder::~TinyPBCoder()
+  {
+  }
+
   // 将 buffer 里面的字节流转换为 message 对象
   void TinyPBCoder::decode(std::vector<AbstractProtocol::s_ptr> &out_messages, TcpBuffer::s_ptr buffer)
   {
+    int decode_count = 0;
     while (1)
     {
-      // 遍历 buffer，找到 PB_START，找到之后，解析出整包的长度。然后得到结束符的位置，判断是否为 PB_END
-      std::vector<char> tmp = buffer->m_buffer;
-      int start_index = buffer->readIndex();
-      int end_index = -1;
-
-      int pk_len = 0;
-      bool parse_success = false;
-      int i = 0;
-      for (i = start_index; i < buffer->writeIndex(); ++i)
+      if (m_pending_pk_len == 0)
       {
-        if (tmp[i] == TinyPBProtocol::PB_START)
+        // 找 PB_START 或 PB_START_V2，前面的字节都是垃圾数据，直接丢掉，下次不用再扫
+        const char *begin = buffer->readPtr();
+        int i = findFirstOf2(begin, begin + buffer->readAble(), TinyPBProtocol::PB_START, TinyPBProtocol::PB_START_V2) - begin;
+        if (i > 0)
         {
-          // 读下去四个字节。由于是网络字节序，需要转为主机字节序
-          if (i + 1 < buffer->writeIndex())
-          {
-            pk_len = getInt32FromNetByte(&tmp[i + 1]);
-            DEBUGLOG("get pk_len = %d", pk_len);
-
-            // 结束符的索引
-            int j = i + pk_len - 1;
-            if (j >= buffer->writeIndex())
-            {
-              continue;
-            }
-            if (tmp[j] == TinyPBProtocol::PB_END)
-            {
-              start_index = i;
-              end_index = j;
-              parse_success = true;
-              break;
-            }
-          }
+          DEBUGLOG("skip %d bytes before PB_START", i);
+          buffer->moveReadIndex(i);
+        }
+        // 读下去四个字节。由于是网络字节序，需要转为主机字节序；不够就等下次
+        if (buffer->readAble() < (int)(sizeof(char) + sizeof(int32_t)))
+        {
+          DEBUGLOG("decode end, read all buffer data");
+          return;
+        }
+
+        int pk_len = getInt32FromNetByte(buffer->readPtr() + 1);
+        DEBUGLOG("get pk_len = %d", pk_len);
+        int min_len = buffer->readPtr()[0] == TinyPBProtocol::PB_START_V2 ? MIN_FRAME_LEN_V2 : MIN_FRAME_LEN;
+        if (pk_len < min_len || (m_max_frame_size > 0 && pk_len > m_max_frame_size))
+        {
+          // 在垃圾数据里误匹配到的开始符，跳过它继续找
+          ERRORLOG("invalid pk_len %d, max frame size %d, skip PB_START", pk_len, m_max_frame_size);
+          buffer->moveReadIndex(1);
+          continue;
         }
+        // 记住包长，包没收完之前后面每次 decode 只比较一下长度
+        m_pending_pk_len = pk_len;
       }
 
-      if (i >= buffer->writeIndex())
+      if (buffer->readAble() < m_pending_pk_len)
       {
-        DEBUGLOG("decode end, read all buffer data");
+        // 按包长把空间准备好，后面的数据直接读进来，不用再反复扩容；大包只先预留 MAX_PREALLOC_SIZE。
+        // 这一轮已经解出了消息时不能动 buffer，它们的 pb_data 还指向这里
+        if (decode_count == 0)
+        {
+          int reserve = m_pending_pk_len - buffer->readAble();
+          buffer->ensureWriteAble(reserve < MAX_PREALLOC_SIZE ? reserve : MAX_PREALLOC_SIZE);
+        }
         return;
       }
-      // 解析成功，获得一整个数据，下面就是一系列的拆分
-      if (parse_success)
+
+      // 收到了完整的包，结束符不对说明这个开始符是误匹配的，跳过它重新找
+      const char *frame = buffer->readPtr();
+      int pk_len = m_pending_pk_len;
+      m_pending_pk_len = 0;
+      if (frame[pk_len - 1] != TinyPBProtocol::PB_END)
       {
-        buffer->moveReadIndex(end_index - start_index + 1);
-        std::shared_ptr<TinyPBProtocol> message = std::make_shared<TinyPBProtocol>();
-        message->m_pk_len = pk_len;
+        ERRORLOG("parse error, frame of pk_len %d not end with PB_END, skip PB_START", pk_len);
+        buffer->moveReadIndex(1);
+        continue;
+      }
 
-        int msg_id_len_index = start_index + sizeof(char) + sizeof(message->m_pk_len);
-        if (msg_id_len_index >= end_index)
-        {
-          message->parse_success = false;
-          ERRORLOG("parse error, msg_id_len_index[%d] >= end_index[%d]", msg_id_len_index, end_index);
-          continue;
-        }
-        message->m_msg_id_len = getInt32FromNetByte(&tmp[msg_id_len_index]);
-        DEBUGLOG("parse msg_id_len=%d", message->m_msg_id_len);
+      // 解析成功，获得一整个数据，下面就是一系列的拆分；moveReadIndex 不会移动数据，frame 一直有效
+      buffer->moveReadIndex(pk_len);
+      std::shared_ptr<TinyPBProtocol> message = std::make_shared<TinyPBProtocol>();
+      message->m_pk_len = pk_len;
 
-        int msg_id_index = msg_id_len_index + sizeof(message->m_msg_id_len);
+      // 各个字段直接在接收缓冲区上解析，pb_data 只记录位置不拷贝
+      bool is_v2 = frame[0] == TinyPBProtocol::PB_START_V2;
+      if (!(is_v2 ? parseFrameV2(message, frame) : parseFrame(message, frame)))
+      {
+        message->parse_success = false;
+        continue;
+      }
 
-        char msg_id[100] = {0};
-        memcpy(&msg_id[0], &tmp[msg_id_index], message->m_msg_id_len);
-        message->m_msg_id = std::string(msg_id);
-        DEBUGLOG("parse msg_id=%s", message->m_msg_id.c_str());
+      // 对端发来 v2 帧或者校验和声明了支持 v2 的 v1 帧，之后这个连接都用 v2 发送
+      if ((is_v2 || message->m_check_sum == TinyPBProtocol::V2_NEGOTIATE_CHECK_SUM) && m_enable_v2 && !m_peer_v2)
+      {
+        DEBUGLOG("peer supports tinypb v2");
+        m_peer_v2 = true;
+      }
 
-        int method_name_len_index = msg_id_index + message->m_msg_id_len;
-        if (method_name_len_index >= end_index)
-        {
-          message->parse_success = false;
-          ERRORLOG("parse error, method_name_len_index[%d] >= end_index[%d]", method_name_len_index, end_index);
-          continue;
-        }
-        message->m_method_name_len = getInt32FromNetByte(&tmp[method_name_len_index]);
+      out_messages.push_back(message);
+      ++decode_count;
+    }
+  }
 
-        int method_name_index = method_name_len_index + sizeof(message->m_method_name_len);
-        char method_name[512] = {0};
-        memcpy(&method_name[0], &tmp[method_name_index], message->m_method_name_len);
-        message->m_method_name = std::string(method_name);
-        DEBUGLOG("parse method_name=%s", message->m_method_name.c_str());
+  // 读一个 4 字节的长度字段和它后面的数据，越界或者长度非法时返回 false
+  static bool readField(const char *&cur, const char *end, const char *&field, int32_t &field_len)
+  {
+    if (end - cur < (int)sizeof(int32_t))
+    {
+      return false;
+    }
+    field_len = getInt32FromNetByte(cur);
+    cur += sizeof(int32_t);
+    if (field_len < 0 || field_len > end - cur)
+    {
+      return false;
+    }
+    field = cur;
+    cur += field_len;
+    return true;
+  }
 
-        int err_code_index = method_name_index + message->m_method_name_len;
-        if (err_code_index >= end_index)
-        {
-          message->parse_success = false;
-          ERRORLOG("parse error, err_code_index[%d] >= end_index[%d]", err_code_index, end_index);
-          continue;
-        }
-        message->m_err_code = getInt32FromNetByte(&tmp[err_code_index]);
+  // 读一个 varint，最多 10 字节
+  static bool readVarint(const char *&cur, const char *end, uint64_t &value)
+  {
+    value = 0;
+    for (int shift = 0; shift < 64 && cur < end; shift += 7)
+    {
+      uint8_t byte = (uint8_t)*cur++;
+      value |= (uint64_t)(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
 
-        int error_info_len_index = err_code_index + sizeof(message->m_err_code);
-        if (error_info_len_index >= end_index)
-        {
-          message->parse_success = false;
-          ERRORLOG("parse error, error_info_len_index[%d] >= end_index[%d]", error_info_len_index, end_index);
-          continue;
-        }
-        message->m_err_info_len = getInt32FromNetByte(&tmp[error_info_len_index]);
+  // 读一个 varint 长度和它后面的字符串
+  static bool readString(const char *&cur, const char *end, std::string &value)
+  {
+    uint64_t len = 0;
+    if (!readVarint(cur, end, len) || len > (uint64_t)(end - cur))
+    {
+      return false;
+    }
+    value.assign(cur, len);
+    cur += len;
+    return true;
+  }
+
+  bool TinyPBCoder::parseFrame(std::shared_ptr<TinyPBProtocol> message, const char *frame)
+  {
+    // 开始符和包长之后是各个字段，最后是 4 字节校验和与结束符
+    const char *cur = frame + sizeof(char) + sizeof(message->m_pk_len);
+    const char *end = frame + message->m_pk_len - sizeof(message->m_check_sum) - sizeof(char);
+    const char *field = NULL;
+
+    if (!readField(cur, end, field, message->m_msg_id_len))
+    {
+      ERRORLOG("parse error, invalid msg_id_len, pk_len[%d]", message->m_pk_len);
+      return false;
+    }
+    message->m_msg_id.assign(field, message->m_msg_id_len);
+    DEBUGLOG("parse msg_id=%s", message->m_msg_id.c_str());
+
+    if (!readField(cur, end, field, message->m_method_name_len))
+    {
+      ERRORLOG("%s | parse error, invalid method_name_len, pk_len[%d]", message->m_msg_id.c_str(), message->m_pk_len);
+      return false;
+    }
+    message->m_method_name.assign(field, message->m_method_name_len);
+    DEBUGLOG("parse method_name=%s", message->m_method_name.c_str());
+
+    if (end - cur < (int)sizeof(message->m_err_code))
+    {
+      ERRORLOG("%s | parse error, no err_code, pk_len[%d]", message->m_msg_id.c_str(), message->m_pk_len);
+      return false;
+    }
+    message->m_err_code = getInt32FromNetByte(cur);
+    cur += sizeof(message->m_err_code);
+
+    if (!readField(cur, end, field, message->m_err_info_len))
+    {
+      ERRORLOG("%s | parse error, invalid err_info_len, pk_len[%d]", message->m_msg_id.c_str(), message->m_pk_len);
+      return false;
+    }
+    message->m_err_info.assign(field, message->m_err_info_len);
+    DEBUGLOG("parse error_info=%s", message->m_err_info.c_str());
 
-        int err_info_index = error_info_len_index + sizeof(message->m_err_info_len);
-        char error_info[512] = {0};
-        memcpy(&error_info[0], &tmp[err_info_index], message->m_err_info_len);
-        message->m_err_info = std::string(error_info);
-        DEBUGLOG("parse error_info=%s", message->m_err_info.c_str());
+    // 剩下的都是 pb_data
+    message->setPbDataView(cur, end - cur);
 
-        int pb_data_len = message->m_pk_len - message->m_method_name_len - message->m_msg_id_len - message->m_err_info_len - 2 - 24;
+    message->m_check_sum = getInt32FromNetByte(end);
+    // 这里校验和去解析
+    message->parse_success = true;
+    return true;
+  }
+
+  bool TinyPBCoder::parseFrameV2(std::shared_ptr<TinyPBProtocol> message, const char *frame)
+  {
+    const char *cur = frame + sizeof(char) + sizeof(message->m_pk_len);
+    const char *end = frame + message->m_pk_len - sizeof(message->m_check_sum) - sizeof(char);
 
-        int pd_data_index = err_info_index + message->m_err_info_len;
-        message->m_pb_data = std::string(&tmp[pd_data_index], pb_data_len);
+    uint32_t check_sum = (uint32_t)getInt32FromNetByte(end);
+    uint32_t expect = crc32c(frame, end - frame);
+    if (check_sum != expect)
+    {
+      ERRORLOG("parse error, check_sum %u not equal to crc32c %u, pk_len[%d]", check_sum, expect, message->m_pk_len);
+      return false;
+    }
+    message->m_check_sum = (int32_t)check_sum;
+    message->m_version = 2;
 
-        // 这里校验和去解析
-        message->parse_success = true;
+    message->m_flags = (uint8_t)*cur++;
+    if (message->m_flags & (TinyPBProtocol::FLAG_COMPRESSED | TinyPBProtocol::FLAG_STREAM | 0xe0))
+    {
+      ERRORLOG("parse error, unsupported flags 0x%x, pk_len[%d]", message->m_flags, message->m_pk_len);
+      return false;
+    }
+
+    if (message->m_flags & TinyPBProtocol::FLAG_STRING_MSG_ID)
+    {
+      if (!readString(cur, end, message->m_msg_id))
+      {
+        ERRORLOG("parse error, invalid msg_id, pk_len[%d]", message->m_pk_len);
+        return false;
+      }
+    }
+    else
+    {
+      if (end - cur < (int)sizeof(uint64_t))
+      {
+        ERRORLOG("parse error, no msg_id, pk_len[%d]", message->m_pk_len);
+        return false;
+      }
+      uint64_t msg_id = 0;
+      for (size_t i = 0; i < sizeof(uint64_t); ++i)
+      {
+        msg_id = (msg_id << 8) | (uint8_t)cur[i];
+      }
+      cur += sizeof(uint64_t);
+      message->m_msg_id = std::to_string((unsigned long long)msg_id);
+    }
+    message->m_msg_id_len = message->m_msg_id.length();
+
+    if (message->m_flags & TinyPBProtocol::FLAG_METHOD_NAME)
+    {
+      if (!readString(cur, end, message->m_method_name))
+      {
+        ERRORLOG("%s | parse error, invalid method_name, pk_len[%d]", message->m_msg_id.c_str(), message->m_pk_len);
+        return false;
+      }
+    }
+    else
+    {
+      if (end - cur < (int)sizeof(uint32_t))
+      {
+        ERRORLOG("%s | parse error, no method_id, pk_len[%d]", message->m_msg_id.c_str(), message->m_pk_len);
+        return false;
+      }
+      uint32_t method_id = (uint32_t)getInt32FromNetByte(cur);
+      cur += sizeof(uint32_t);
+      if (!TinyPBProtocol::GetMethodName(method_id, message->m_method_name))
+      {
+        // 本端没有注册这个方法，留给上层按找不到方法处理
+        ERRORLOG("%s | unknown method_id %u", message->m_msg_id.c_str(), method_id);
+        message->m_method_name = "#" + std::to_string(method_id);
+      }
+    }
+    message->m_method_name_len = message->m_method_name.length();
 
-        out_messages.push_back(message);
+    message->m_err_code = 0;
+    message->m_err_info.clear();
+    if (message->m_flags & TinyPBProtocol::FLAG_ERROR)
+    {
+      uint64_t zigzag = 0;
+      if (!readVarint(cur, end, zigzag) || !readString(cur, end, message->m_err_info))
+      {
+        ERRORLOG("%s | parse error, invalid err_code or err_info, pk_len[%d]", message->m_msg_id.c_str(), message->m_pk_len);
+        return false;
       }
+      message->m_err_code = (int32_t)((uint32_t)(zigzag >> 1) ^ -(uint32_t)(zigzag & 1));
     }
+    message->m_err_info_len = message->m_err_info.length();
+
+    message->setPbDataView(cur, end - cur);
+    message->parse_success = true;
+    DEBUGLOG("parse v2 msg_id=%s, method_name=%s", message->m_msg_id.c_str(), message->m_method_name.c_str());
+    return true;
   }
 
-  const char *TinyPBCoder::encodeTinyPB(std::shared_ptr<TinyPBProtocol> message, int &len)
+  void TinyPBCoder::encodeHeader(std::shared_ptr<TinyPBProtocol> message, std::string &header)
   {
     if (message->m_msg_id.empty())
     {
@@ -158,77 +415,113 @@ namespace rocket
     }
     DEBUGLOG("msg_id = %s", message->m_msg_id.c_str());
     int pk_len = 2 + 24 + message->m_msg_id.length() + message->m_method_name.length() + message->m_err_info.length() + message->m_pb_data.length();
-    DEBUGLOG("pk_len = %", pk_len);
+    DEBUGLOG("pk_len = %d", pk_len);
 
-    char *buf = reinterpret_cast<char *>(malloc(pk_len));
-    char *tmp = buf;
+    header.reserve(header.length() + 1 + 20 + message->m_msg_id.length() + message->m_method_name.length() + message->m_err_info.length());
 
-    *tmp = TinyPBProtocol::PB_START;
-    tmp++;
+    header.push_back(TinyPBProtocol::PB_START);
+    appendInt32(header, pk_len);
 
-    int32_t pk_len_net = htonl(pk_len);
-    memcpy(tmp, &pk_len_net, sizeof(pk_len_net));
-    tmp += sizeof(pk_len_net);
+    appendInt32(header, message->m_msg_id.length());
+    header.append(message->m_msg_id);
 
-    int msg_id_len = message->m_msg_id.length();
-    int32_t msg_id_len_net = htonl(msg_id_len);
-    memcpy(tmp, &msg_id_len_net, sizeof(msg_id_len_net));
-    tmp += sizeof(msg_id_len_net);
+    appendInt32(header, message->m_method_name.length());
+    header.append(message->m_method_name);
 
-    if (!message->m_msg_id.empty())
-    {
-      memcpy(tmp, &(message->m_msg_id[0]), msg_id_len);
-      tmp += msg_id_len;
-    }
+    appendInt32(header, message->m_err_code);
 
-    int method_name_len = message->m_method_name.length();
-    int32_t method_name_len_net = htonl(method_name_len);
-    memcpy(tmp, &method_name_len_net, sizeof(method_name_len_net));
-    tmp += sizeof(method_name_len_net);
+    appendInt32(header, message->m_err_info.length());
+    header.append(message->m_err_info);
 
-    if (!message->m_method_name.empty())
+    message->m_version = 1;
+    message->m_pk_len = pk_len;
+    message->m_msg_id_len = message->m_msg_id.length();
+    message->m_method_name_len = message->m_method_name.length();
+    message->m_err_info_len = message->m_err_info.length();
+    // 本端支持 v2 时借校验和告诉对端，老版本不校验 v1 的校验和
+    message->m_check_sum = m_enable_v2 ? TinyPBProtocol::V2_NEGOTIATE_CHECK_SUM : 1;
+    message->parse_success = true;
+  }
+
+  void TinyPBCoder::encodeHeaderV2(std::shared_ptr<TinyPBProtocol> message, std::string &header)
+  {
+    if (message->m_msg_id.empty())
     {
-      memcpy(tmp, &(message->m_method_name[0]), method_name_len);
-      tmp += method_name_len;
+      message->m_msg_id = "123456789";
     }
+    size_t start = header.length();
+    header.reserve(start + 1 + 4 + 1 + 8 + 4 + message->m_err_info.length() + 16);
 
-    int32_t err_code_net = htonl(message->m_err_code);
-    memcpy(tmp, &err_code_net, sizeof(err_code_net));
-    tmp += sizeof(err_code_net);
+    uint8_t flags = 0;
+    uint64_t msg_id = 0;
+    uint32_t method_id = 0;
+    if (!getNumericMsgId(message->m_msg_id, msg_id))
+    {
+      flags |= TinyPBProtocol::FLAG_STRING_MSG_ID;
+    }
+    if (!TinyPBProtocol::GetMethodId(message->m_method_name, method_id))
+    {
+      flags |= TinyPBProtocol::FLAG_METHOD_NAME;
+    }
+    if (message->m_err_code != 0 || !message->m_err_info.empty())
+    {
+      flags |= TinyPBProtocol::FLAG_ERROR;
+    }
 
-    int err_info_len = message->m_err_info.length();
-    int32_t err_info_len_net = htonl(err_info_len);
-    memcpy(tmp, &err_info_len_net, sizeof(err_info_len_net));
-    tmp += sizeof(err_info_len_net);
+    header.push_back(TinyPBProtocol::PB_START_V2);
+    appendInt32(header, 0); // 包长最后回填
+    header.push_back((char)flags);
 
-    if (!message->m_err_info.empty())
+    if (flags & TinyPBProtocol::FLAG_STRING_MSG_ID)
     {
-      memcpy(tmp, &(message->m_err_info[0]), err_info_len);
-      tmp += err_info_len;
+      appendString(header, message->m_msg_id);
+    }
+    else
+    {
+      appendUInt64(header, msg_id);
     }
 
-    if (!message->m_pb_data.empty())
+    if (flags & TinyPBProtocol::FLAG_METHOD_NAME)
     {
-      memcpy(tmp, &(message->m_pb_data[0]), message->m_pb_data.length());
-      tmp += message->m_pb_data.length();
+      appendString(header, message->m_method_name);
+    }
+    else
+    {
+      appendInt32(header, method_id);
     }
 
-    int32_t check_sum_net = htonl(1);
-    memcpy(tmp, &check_sum_net, sizeof(check_sum_net));
-    tmp += sizeof(check_sum_net);
+    if (flags & TinyPBProtocol::FLAG_ERROR)
+    {
+      uint32_t err_code = (uint32_t)message->m_err_code;
+      appendVarint(header, (err_code << 1) ^ (uint32_t)(message->m_err_code >> 31));
+      appendString(header, message->m_err_info);
+    }
 
-    *tmp = TinyPBProtocol::PB_END;
+    int pk_len = header.length() - start + message->m_pb_data.length() + sizeof(message->m_check_sum) + sizeof(char);
+    int32_t pk_len_net = htonl(pk_len);
+    memcpy(&header[start + 1], &pk_len_net, sizeof(pk_len_net));
+    DEBUGLOG("msg_id = %s, v2 pk_len = %d, flags = 0x%x", message->m_msg_id.c_str(), pk_len, flags);
 
+    message->m_version = 2;
+    message->m_flags = flags;
     message->m_pk_len = pk_len;
-    message->m_msg_id_len = msg_id_len;
-    message->m_method_name_len = method_name_len;
-    message->m_err_info_len = err_info_len;
+    message->m_msg_id_len = message->m_msg_id.length();
+    message->m_method_name_len = message->m_method_name.length();
+    message->m_err_info_len = message->m_err_info.length();
+    message->m_check_sum = (int32_t)crc32c(header.data() + start, header.length() - start);
     message->parse_success = true;
-    len = pk_len;
+  }
 
-    DEBUGLOG("encode message[%s] success", message->m_msg_id.c_str());
+  void TinyPBCoder::encodeTail(std::shared_ptr<TinyPBProtocol> message, std::string &tail)
+  {
+    if (message->m_version == 2)
+    {
+      message->m_check_sum = (int32_t)crc32cExtend(message->m_check_sum, message->m_pb_data.data(), message->m_pb_data.length());
+    }
+    appendInt32(tail, message->m_check_sum);
+    tail.push_back(TinyPBProtocol::PB_END);
 
-    return buf;
+    DEBUGLOG("encode message[%s] success", message->m_msg_id.c_str());
   }
 
 }
\ No newline at end of file
@@ -7,21 +7,65 @@
 namespace rocket
 {
 
+  /// @brief TinyPB 编解码，一个连接一个 coder
+  /// v1 帧：PB_START | pk_len | msg_id_len | msg_id | method_name_len | method_name | err_code | err_info_len | err_info | pb_data | check_sum | PB_END，
+  /// 除开始符和结束符外都是 4 字节网络序整数或变长字符串，校验和固定为 1。
+  /// v2 帧：PB_START_V2 | pk_len | flags | msg_id | method | [err_code | err_info] | pb_data | crc32c | PB_END，
+  /// msg_id 是 8 字节整数（FLAG_STRING_MSG_ID 时为 varint 长度加字符串），方法是 4 字节方法号（FLAG_METHOD_NAME 时为 varint 长度加名字），
+  /// err_code 是 zigzag varint，只有 FLAG_ERROR 时出现；crc32c 覆盖它之前的所有字节。
+  /// 两端都打开 v2 时，先发的 v1 帧的校验和填 V2_NEGOTIATE_CHECK_SUM，收到它或者 v2 帧之后这个连接改用 v2 发送；
+  /// 解码总是同时接受两种帧，老版本的对端不读 v1 的校验和，协商对它和上层都不可见
   class TinyPBCoder : public AbstractCoder
   {
 
   public:
-    TinyPBCoder() {}
-    ~TinyPBCoder() {}
+    TinyPBCoder();
+    ~TinyPBCoder();
 
     // 将 message 对象转化为字节流，写入到 buffer
     void encode(std::vector<AbstractProtocol::s_ptr> &messages, TcpBuffer::s_ptr out_buffer);
 
-    // 将 buffer 里面的字节流转换为 message 对象
+    // pb_data 只引用不拷贝，message 在发送完之前不能修改
+    void encode(std::vector<AbstractProtocol::s_ptr> &messages, TcpOutputQueue::s_ptr out_queue);
+
+    // 将 buffer 里面的字节流转换为 message 对象，pb_data 是指向 buffer 的视图，见 TinyPBProtocol::pbData。
+    // 包没收完时记住包长并按包长预留 buffer 空间（最多 MAX_PREALLOC_SIZE），之后的调用在收齐之前直接返回，不再重新扫描
+    // 一个连接一个 coder，状态跟着连接走
     void decode(std::vector<AbstractProtocol::s_ptr> &out_messages, TcpBuffer::s_ptr buffer);
 
+  public:
+    static const int MIN_FRAME_LEN = 2 + 24; // 开始符、结束符和 6 个 4 字节字段
+
+    static const int MIN_FRAME_LEN_V2 = 2 + 4 + 1 + 1 + 1 + 4; // 开始符、结束符、包长、flags、空 msg_id、空方法名、校验和
+
+    // 包头到了之后最多按这么多预留接收空间，更大的包随数据到达再扩容，
+    // 避免一个声明了大包长、实际不发数据的对端让每个连接都占住 max_frame_size
+    static const int MAX_PREALLOC_SIZE = 1024 * 1024;
+
+  private:
+    // frame 指向开始符，长度为 message->m_pk_len，所有字段都做越界检查
+    bool parseFrame(std::shared_ptr<TinyPBProtocol> message, const char *frame);
+
+    // 帧里 pb_data 之前的部分写到 header，同时填好 message 里的各个长度字段
+    void encodeHeader(std::shared_ptr<TinyPBProtocol> message, std::string &header);
+
+    // v2 帧的解析，先校验 CRC32C 再解析字段
+    bool parseFrameV2(std::shared_ptr<TinyPBProtocol> message, const char *frame);
+
+    // v2 帧头，同时把帧头部分的 CRC32C 记到 message->m_check_sum，encodeTail 再接着算 pb_data
+    void encodeHeaderV2(std::shared_ptr<TinyPBProtocol> message, std::string &header);
+
+    // 帧里 pb_data 之后的部分：校验和、结束符
+    void encodeTail(std::shared_ptr<TinyPBProtocol> message, std::string &tail);
+
   private:
-    const char *encodeTinyPB(std::shared_ptr<TinyPBProtocol> message, int &len);
+    bool m_enable_v2{true}; // 本端支持 v2，见 <server><tinypb_v2>
+
+    bool m_peer_v2{false}; // 对端声明过支持 v2，之后发送都用 v2
+
+    int m_pending_pk_len{0}; // 正在等待的包的长度，0 表示还没找到包头
+
+    int m_max_frame_size{0}; // 超过这个包长的视为误匹配，0 表示不限制
   };
 
 }
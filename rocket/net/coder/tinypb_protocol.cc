@@ -1,9 +1,150 @@
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
 #include "rocket/net/coder/tinypb_protocol.h"
+#include "rocket/common/crc32c.h"
+#include "rocket/common/mutex.h"
+#include "rocket/common/log.h"
 
 namespace rocket
 {
 
     char TinyPBProtocol::PB_START = 0x02;
     char TinyPBProtocol::PB_END = 0x03;
+    char TinyPBProtocol::PB_START_V2 = 0x04;
+
+    // 方法表只在注册服务、第一次用到某个 stub 时修改，编解码每帧都要查。
+    // 写的时候在锁里拷贝一份改好再整体换上去，读的时候只 load 一次指针，不加锁。
+    // 换下来的旧表可能还有 IO 线程在读，不释放；注册次数只和服务个数有关
+    struct MethodTable
+    {
+        std::unordered_map<uint32_t, std::string> m_names; // 方法号 -> 方法名
+        std::unordered_map<std::string, uint32_t> m_ids;   // 方法名 -> 方法号，不含冲突的方法
+        std::unordered_set<std::string> m_by_name;         // 方法号和别的方法冲突，只能按名字发送
+    };
+
+    static Mutex g_method_mutex;
+    static std::vector<MethodTable *> g_method_tables;
+    static std::atomic<const MethodTable *> g_method_table(NULL);
+
+    void TinyPBProtocol::RegisterMethods(const std::vector<std::string> &method_names)
+    {
+        ScopeMutex<Mutex> lock(g_method_mutex);
+        const MethodTable *current = g_method_table.load(std::memory_order_acquire);
+        MethodTable *table = current ? new MethodTable(*current) : new MethodTable();
+        bool changed = false;
+        for (size_t i = 0; i < method_names.size(); ++i)
+        {
+            const std::string &method_name = method_names[i];
+            if (table->m_ids.count(method_name) || table->m_by_name.count(method_name))
+            {
+                continue;
+            }
+            changed = true;
+            uint32_t method_id = crc32c(method_name.data(), method_name.length());
+            auto it = table->m_names.find(method_id);
+            if (it != table->m_names.end())
+            {
+                ERRORLOG("method id of [%s] conflicts with [%s], send it by name", method_name.c_str(), it->second.c_str());
+                table->m_by_name.insert(method_name);
+                continue;
+            }
+            table->m_names[method_id] = method_name;
+            table->m_ids[method_name] = method_id;
+        }
+        if (!changed)
+        {
+            delete table;
+            return;
+        }
+        g_method_tables.push_back(table);
+        g_method_table.store(table, std::memory_order_release);
+    }
+
+    bool TinyPBProtocol::IsMethodRegistered(const std::string &method_name)
+    {
+        const MethodTable *table = g_method_table.load(std::memory_order_acquire);
+        return table && (table->m_ids.count(method_name) || table->m_by_name.count(method_name));
+    }
+
+    bool TinyPBProtocol::GetMethodId(const std::string &method_name, uint32_t &method_id)
+    {
+        const MethodTable *table = g_method_table.load(std::memory_order_acquire);
+        if (!table)
+        {
+            return false;
+        }
+        auto it = table->m_ids.find(method_name);
+        if (it == table->m_ids.end())
+        {
+            return false;
+        }
+        method_id = it->second;
+        return true;
+    }
+
+    bool TinyPBProtocol::GetMethodName(uint32_t method_id, std::string &method_name)
+    {
+        const MethodTable *table = g_method_table.load(std::memory_order_acquire);
+        if (!table)
+        {
+            return false;
+        }
+        auto it = table->m_names.find(method_id);
+        if (it == table->m_names.end())
+        {
+            return false;
+        }
+        method_name = it->second;
+        return true;
+    }
+
+    const char *TinyPBProtocol::HEARTBEAT_METHOD = "rocket.heartbeat";
+    const char *TinyPBProtocol::HEARTBEAT_PING = "ping";
+    const char *TinyPBProtocol::HEARTBEAT_PONG = "pong";
+
+    std::shared_ptr<TinyPBProtocol> TinyPBProtocol::CreateHeartbeat(bool is_ping)
+    {
+        std::shared_ptr<TinyPBProtocol> message = std::make_shared<TinyPBProtocol>();
+        message->m_msg_id = is_ping ? HEARTBEAT_PING : HEARTBEAT_PONG;
+        message->m_method_name = HEARTBEAT_METHOD;
+        return message;
+    }
+
+    bool TinyPBProtocol::isHeartbeat() const
+    {
+        return m_method_name == HEARTBEAT_METHOD;
+    }
+
+    bool TinyPBProtocol::isHeartbeatPing() const
+    {
+        return isHeartbeat() && m_msg_id == HEARTBEAT_PING;
+    }
+
+    const char *TinyPBProtocol::pbData() const
+    {
+        return m_pb_view ? m_pb_view : m_pb_data.data();
+    }
+
+    int TinyPBProtocol::pbDataLength() const
+    {
+        return m_pb_view ? m_pb_view_len : (int)m_pb_data.length();
+    }
+
+    void TinyPBProtocol::setPbDataView(const char *data, int len)
+    {
+        m_pb_view = data;
+        m_pb_view_len = len;
+    }
+
+    void TinyPBProtocol::detach()
+    {
+        if (m_pb_view)
+        {
+            m_pb_data.assign(m_pb_view, m_pb_view_len);
+            m_pb_view = NULL;
+            m_pb_view_len = 0;
+        }
+    }
 
 }
\ No newline at end of file
@@ -2,6 +2,9 @@
 #define ROCKET_NET_CODER_TINYPB_PROTOCOL_H
 
 #include <string>
+#include <memory>
+#include <vector>
+#include <stdint.h>
 #include "rocket/net/coder/abstract_protocol.h"
 
 namespace rocket
@@ -17,7 +20,57 @@ namespace rocket
     static char PB_START;
     static char PB_END;
 
+    // v2 帧的开始符，结束符和 v1 相同。帧格式见 TinyPBCoder
+    static char PB_START_V2;
+
+    // v1 帧的校验和固定为 1，老版本解码时从来不读它；本端支持 v2 时填这个值，对端收到之后这个连接改用 v2 发送
+    static const int32_t V2_NEGOTIATE_CHECK_SUM = 2;
+
+    // v2 帧的 flags
+    static const uint8_t FLAG_COMPRESSED = 0x01;    // pb_data 压缩过，暂不支持
+    static const uint8_t FLAG_STREAM = 0x02;        // 流式消息，暂不支持
+    static const uint8_t FLAG_ERROR = 0x04;         // 带 err_code 和 err_info
+    static const uint8_t FLAG_METHOD_NAME = 0x08;   // 方法以名字发送，否则是 4 字节方法号
+    static const uint8_t FLAG_STRING_MSG_ID = 0x10; // msg_id 不是 64 位整数，以字符串发送
+
+    // 方法号是方法全名的 CRC32C，两端各自计算，不需要交换映射表。
+    // 注册过的方法才按方法号发送，和已注册的其它方法冲突的继续按名字发送。
+    // 注册在注册服务或者第一次用到某个 stub 时做一次，一个服务的方法一起注册；查询不加锁
+    static void RegisterMethods(const std::vector<std::string> &method_names);
+
+    // 注册过（包括因为冲突只能按名字发送的）返回 true
+    static bool IsMethodRegistered(const std::string &method_name);
+
+    // 注册过并且可以按方法号发送时返回 true
+    static bool GetMethodId(const std::string &method_name, uint32_t &method_id);
+
+    static bool GetMethodName(uint32_t method_id, std::string &method_name);
+
+    // 心跳帧：method_name 为 HEARTBEAT_METHOD，msg_id 为 ping 或 pong，不会分发给 RPC 服务
+    static const char *HEARTBEAT_METHOD;
+    static const char *HEARTBEAT_PING;
+    static const char *HEARTBEAT_PONG;
+
+    static std::shared_ptr<TinyPBProtocol> CreateHeartbeat(bool is_ping);
+
+    bool isHeartbeat() const;
+
+    bool isHeartbeatPing() const;
+
+    // pb 数据。解码得到的消息不拷贝 pb 数据，而是指向连接的接收缓冲区，只在处理这批消息的回调里有效；
+    // 需要把消息留到回调之外时先调用 detach 拷贝到 m_pb_data
+    const char *pbData() const;
+
+    int pbDataLength() const;
+
+    void setPbDataView(const char *data, int len);
+
+    void detach();
+
   public:
+    int m_version{1};  // 编码时由连接协商的结果决定，解码时由开始符决定
+    uint8_t m_flags{0}; // 只对 v2 有效
+
     int32_t m_pk_len{0};
     int32_t m_msg_id_len{0};
     // msg_id 继承父类
@@ -29,6 +82,8 @@ namespace rocket
     std::string m_err_info;
     //protobuf 数据
     std::string m_pb_data;
+    const char *m_pb_view{NULL}; // 不为空时 pb 数据以它为准
+    int m_pb_view_len{0};
     int32_t m_check_sum{0};
 
     bool parse_success{false};
@@ -0,0 +1,89 @@
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <stdlib.h>
+#include "rocket/net/epoll_poller.h"
+#include "rocket/common/log.h"
+
+namespace rocket
+{
+
+  EpollPoller::EpollPoller()
+  {
+    m_epoll_fd = epoll_create(10);
+
+    if (m_epoll_fd == -1)
+    {
+      ERRORLOG("failed to create event loop, epoll_create error, error info[%d]", errno);
+      exit(0);
+    }
+  }
+
+  EpollPoller::~EpollPoller()
+  {
+    close(m_epoll_fd);
+  }
+
+  void EpollPoller::addEvent(FdEvent *event)
+  {
+    int fd = event->getFd();
+    if (fd < 0)
+    {
+      return;
+    }
+    if ((size_t)fd >= m_listen_states.size())
+    {
+      m_listen_states.resize(fd + 1);
+    }
+
+    ListenState &state = m_listen_states[fd];
+    epoll_event tmp = event->getEpollEvent();
+
+    // ONESHOT 触发后内核已经禁用了这个 fd，即使掩码没变也要 MOD 重新打开
+    if (state.m_registered && state.m_events == tmp.events && state.m_event == event && !(tmp.events & EPOLLONESHOT))
+    {
+      return;
+    }
+
+    int op = state.m_registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    DEBUGLOG("epoll_event.events = %d", (int)tmp.events);
+    int rt = epoll_ctl(m_epoll_fd, op, fd, &tmp);
+    if (rt == -1 && (errno == ENOENT || errno == EEXIST))
+    {
+      // fd 没有经过 deleteEvent 就被关闭后复用，epoll 里的状态和缓存不一致，换一种操作重试
+      op = (op == EPOLL_CTL_MOD) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+      rt = epoll_ctl(m_epoll_fd, op, fd, &tmp);
+    }
+    if (rt == -1)
+    {
+      ERRORLOG("failed epoll_ctl when add fd, errno=%d, error=%s", errno, strerror(errno));
+      return;
+    }
+    state.m_registered = true;
+    state.m_events = tmp.events;
+    state.m_event = event;
+    DEBUGLOG("add event success, fd[%d]", fd);
+  }
+
+  void EpollPoller::deleteEvent(FdEvent *event)
+  {
+    int fd = event->getFd();
+    if (fd < 0 || (size_t)fd >= m_listen_states.size() || !m_listen_states[fd].m_registered)
+    {
+      return;
+    }
+    int rt = epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+    if (rt == -1)
+    {
+      ERRORLOG("failed epoll_ctl when delete fd, errno=%d, error=%s", errno, strerror(errno));
+    }
+    m_listen_states[fd] = ListenState();
+    DEBUGLOG("delete event success, fd[%d]", fd);
+  }
+
+  int EpollPoller::poll(std::vector<epoll_event> &events, int timeout_ms)
+  {
+    return epoll_wait(m_epoll_fd, &events[0], (int)events.size(), timeout_ms);
+  }
+
+}
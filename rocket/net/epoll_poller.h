@@ -0,0 +1,43 @@
+#ifndef ROCKET_NET_EPOLL_POLLER_H
+#define ROCKET_NET_EPOLL_POLLER_H
+
+#include "rocket/net/poller.h"
+
+namespace rocket
+{
+
+  class EpollPoller : public Poller
+  {
+  public:
+    EpollPoller();
+
+    ~EpollPoller();
+
+    void addEvent(FdEvent *event);
+
+    void deleteEvent(FdEvent *event);
+
+    int poll(std::vector<epoll_event> &events, int timeout_ms);
+
+    const char *name()
+    {
+      return "epoll";
+    }
+
+  private:
+    struct ListenState
+    {
+      bool m_registered{false};
+      uint32_t m_events{0};
+      FdEvent *m_event{NULL};
+    };
+
+    int m_epoll_fd{-1};
+
+    // 以 fd 为下标缓存已经注册到 epoll 的事件，监听不变时跳过 epoll_ctl
+    std::vector<ListenState> m_listen_states;
+  };
+
+}
+
+#endif
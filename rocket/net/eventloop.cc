@@ -2,51 +2,126 @@
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
 #include <string.h>
+#include <algorithm>
 #include "rocket/net/eventloop.h"
+#include "rocket/net/poller.h"
 #include "rocket/common/log.h"
 #include "rocket/common/util.h"
-
-#define ADD_TO_EPOLL()                                                                    \
-  auto it = m_listen_fds.find(event->getFd());                                            \
-  int op = EPOLL_CTL_ADD;                                                                 \
-  if (it != m_listen_fds.end())                                                           \
-  {                                                                                       \
-    op = EPOLL_CTL_MOD;                                                                   \
-  }                                                                                       \
-  epoll_event tmp = event->getEpollEvent();                                               \
-  INFOLOG("epoll_event.events = %d", (int)tmp.events);                                    \
-  int rt = epoll_ctl(m_epoll_fd, op, event->getFd(), &tmp);                               \
-  if (rt == -1)                                                                           \
-  {                                                                                       \
-    ERRORLOG("failed epoll_ctl when add fd, errno=%d, error=%s", errno, strerror(errno)); \
-  }                                                                                       \
-  m_listen_fds.insert(event->getFd());                                                    \
-  DEBUGLOG("add event success, fd[%d]", event->getFd())
-
-#define DELETE_TO_EPOLL()                                                                 \
-  auto it = m_listen_fds.find(event->getFd());                                            \
-  if (it == m_listen_fds.end())                                                           \
-  {                                                                                       \
-    return;                                                                               \
-  }                                                                                       \
-  int op = EPOLL_CTL_DEL;                                                                 \
-  epoll_event tmp = event->getEpollEvent();                                               \
-  int rt = epoll_ctl(m_epoll_fd, op, event->getFd(), NULL);                               \
-  if (rt == -1)                                                                           \
-  {                                                                                       \
-    ERRORLOG("failed epoll_ctl when add fd, errno=%d, error=%s", errno, strerror(errno)); \
-  }                                                                                       \
-  m_listen_fds.erase(event->getFd());                                                     \
-  DEBUGLOG("delete event success, fd[%d]", event->getFd());
+#include "rocket/common/clock.h"
+#include "rocket/common/config.h"
 
 namespace rocket
 {
 
   static thread_local EventLoop *t_current_eventloop = NULL;
   static int g_epoll_max_timeout = 10000;
-  static int g_epoll_max_events = 10;
+  static int g_epoll_init_events = 16;  // poll 结果数组的初始大小
+  static int g_epoll_max_events = 4096; // 结果数组按就绪数量翻倍扩容的上限
+  // 每个优先级任务队列单轮 loop 的执行预算(微秒)，0 表示不限制
+  static int64_t g_task_lane_budget_us[TaskPriorityCount] = {0, 0, 2000, 1000};
+
+  MpscTaskQueue::MpscTaskQueue(size_t capacity)
+  {
+    size_t size = 2;
+    while (size < capacity)
+    {
+      size <<= 1;
+    }
+    m_cells = new Cell[size];
+    for (size_t i = 0; i < size; ++i)
+    {
+      m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+    }
+    m_mask = size - 1;
+  }
+
+  MpscTaskQueue::~MpscTaskQueue()
+  {
+    if (m_cells)
+    {
+      delete[] m_cells;
+      m_cells = NULL;
+    }
+  }
+
+  bool MpscTaskQueue::tryPush(std::function<void()> &cb)
+  {
+    size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    while (true)
+    {
+      Cell *cell = &m_cells[pos & m_mask];
+      size_t seq = cell->m_sequence.load(std::memory_order_acquire);
+      intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+      if (diff == 0)
+      {
+        // 槽位空闲，抢占这个位置
+        if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          cell->m_task.swap(cb);
+          cell->m_sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (diff < 0)
+      {
+        // 环已满
+        return false;
+      }
+      else
+      {
+        pos = m_enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void MpscTaskQueue::push(std::function<void()> cb)
+  {
+    if (!m_has_overflow.load(std::memory_order_acquire) && tryPush(cb))
+    {
+      return;
+    }
+
+    ScopeMutex<Mutex> lock(m_overflow_mutex);
+    m_overflow_tasks.push(std::move(cb));
+    m_has_overflow.store(true, std::memory_order_release);
+    lock.unlock();
+  }
+
+  size_t MpscTaskQueue::popAll(std::vector<std::function<void()>> &tasks)
+  {
+    size_t count = 0;
+    while (true)
+    {
+      Cell *cell = &m_cells[m_dequeue_pos & m_mask];
+      size_t seq = cell->m_sequence.load(std::memory_order_acquire);
+      if ((intptr_t)seq - (intptr_t)(m_dequeue_pos + 1) < 0)
+      {
+        // 生产者还没写完这个槽位，或者队列已空
+        break;
+      }
+      tasks.emplace_back();
+      tasks.back().swap(cell->m_task);
+      cell->m_sequence.store(m_dequeue_pos + m_mask + 1, std::memory_order_release);
+      ++m_dequeue_pos;
+      ++count;
+    }
+
+    if (m_has_overflow.load(std::memory_order_acquire))
+    {
+      ScopeMutex<Mutex> lock(m_overflow_mutex);
+      while (!m_overflow_tasks.empty())
+      {
+        tasks.emplace_back(std::move(m_overflow_tasks.front()));
+        m_overflow_tasks.pop();
+        ++count;
+      }
+      m_has_overflow.store(false, std::memory_order_release);
+      lock.unlock();
+    }
+    return count;
+  }
 
-  EventLoop::EventLoop()
+  EventLoop::EventLoop() : m_result_events(g_epoll_init_events)
   {
     if (t_current_eventloop != NULL)
     {
@@ -55,24 +130,22 @@ namespace rocket
     }
     m_thread_id = getThreadId();
 
-    m_epoll_fd = epoll_create(10);
+    m_poller = Poller::CreatePoller();
 
-    if (m_epoll_fd == -1)
+    if (Config::GetGlobalConfig() && Config::GetGlobalConfig()->m_tsc_clock && !Clock::EnableTsc())
     {
-      ERRORLOG("failed to create event loop, epoll_create error, error info[%d]", errno);
-      exit(0);
+      ERRORLOG("invariant TSC is not available on this cpu, use clock_gettime");
     }
 
     initWakeUpFdEevent();
     initTimer();
 
-    INFOLOG("succ create event loop in thread %d", m_thread_id);
+    INFOLOG("succ create event loop in thread %d, poller[%s]", m_thread_id, m_poller->name());
     t_current_eventloop = this;
   }
 
   EventLoop::~EventLoop()
   {
-    close(m_epoll_fd);
     if (m_wakeup_fd_event)
     {
       delete m_wakeup_fd_event;
@@ -83,11 +156,17 @@ namespace rocket
       delete m_timer;
       m_timer = NULL;
     }
+    if (m_poller)
+    {
+      delete m_poller;
+      m_poller = NULL;
+    }
   }
 
   void EventLoop::initTimer()
   {
-    m_timer = new Timer();
+    m_timer = new Timer(this);
+    m_timer->setStats(&m_stats);
     addEpollEvent(m_timer);
   }
 
@@ -96,6 +175,11 @@ namespace rocket
     m_timer->addTimerEvent(event);
   }
 
+  void EventLoop::deleteTimerEvent(TimerEvent::s_ptr event)
+  {
+    m_timer->deleteTimerEvent(event);
+  }
+
   void EventLoop::initWakeUpFdEevent()
   {
     m_wakeup_fd = eventfd(0, EFD_NONBLOCK);
@@ -122,79 +206,225 @@ namespace rocket
   {
     // loop先执行已经触发的任务
     m_is_looping = true;
+    int64_t poll_end = Clock::Update();
     while (!m_stop_flag)
     {
-      ScopeMutex<Mutex> lock(m_mutex);
-      std::queue<std::function<void()>> tmp_tasks;
-      m_pending_tasks.swap(tmp_tasks);
-      lock.unlock();
-
-      while (!tmp_tasks.empty())
-      {
-        std::function<void()> cb = tmp_tasks.front();
-        tmp_tasks.pop();
-        if (cb)
-        {
-          cb();
-        }
-      }
+      // 先清掉 wakeup 标志再取任务，之后加入的任务一定会重新写 eventfd
+      m_wakeup_pending.store(false);
+      bool has_backlog = runTasks();
 
       // 如果有定时任务需要执行，那么执行
       // 1. 怎么判断一个定时任务需要执行？ （now() > TimerEvent.arrtive_time）
       // 2. arrtive_time 如何让 eventloop 监听
 
-      int timeout = g_epoll_max_timeout;
-      epoll_event result_events[g_epoll_max_events];
-      // DEBUGLOG("now begin to epoll_wait");
-      int rt = epoll_wait(m_epoll_fd, result_events, g_epoll_max_events, timeout);
-      // DEBUGLOG("now end epoll_wait, rt = %d", rt);
+      int timeout = has_backlog ? 0 : g_epoll_max_timeout;
+      // DEBUGLOG("now begin to poll");
+      int64_t poll_begin = Clock::FastUs();
+
+      // 上一轮 poll 返回到这一轮 poll 之间都在处理事件和任务，alpha = 1/8
+      int64_t lag = m_stats.m_loop_lag_us.load(std::memory_order_relaxed);
+      m_stats.m_loop_lag_us.store(lag + (poll_begin - poll_end - lag) / 8, std::memory_order_relaxed);
+
+      int rt = pollEvents(timeout);
+      // 每轮 poll 返回后刷新一次本线程的缓存时间，这一轮里的定时器和统计都用它
+      poll_end = Clock::Update();
+      int64_t poll_cost = poll_end - poll_begin;
+      // DEBUGLOG("now end poll, rt = %d", rt);
+      EventLoopStats::Increase(m_stats.m_poll_time_us, poll_cost);
+      m_stats.m_poll_wait_us.record(poll_cost);
 
       if (rt < 0)
       {
-        ERRORLOG("epoll_wait error, errno=%d, error=%s", errno, strerror(errno));
+        if (errno != EINTR)
+        {
+          ERRORLOG("%s poll error, errno=%d, error=%s", m_poller->name(), errno, strerror(errno));
+        }
       }
       else
       {
+        EventLoopStats::Increase(m_stats.m_event_count, rt);
+        m_stats.m_events_per_wakeup.record(rt);
         for (int i = 0; i < rt; ++i)
         {
-          epoll_event trigger_event = result_events[i];
-          FdEvent *fd_event = static_cast<FdEvent *>(trigger_event.data.ptr);
-          if (fd_event == NULL)
-          {
-            ERRORLOG("fd_event = NULL, continue");
-            continue;
-          }
-
-          // int event = (int)(trigger_event.events);
-          // DEBUGLOG("unkonow event = %d", event);
-
-          if (trigger_event.events & EPOLLIN)
-          {
-
-            // DEBUGLOG("fd %d trigger EPOLLIN event", fd_event->getFd())
-            addTask(fd_event->handler(FdEvent::IN_EVENT));
-          }
-          if (trigger_event.events & EPOLLOUT)
-          {
-            // DEBUGLOG("fd %d trigger EPOLLOUT event", fd_event->getFd())
-            addTask(fd_event->handler(FdEvent::OUT_EVENT));
-          }
-
-          // EPOLLHUP EPOLLERR
-          if (trigger_event.events & EPOLLERR)
-          {
-            DEBUGLOG("fd %d trigger EPOLLERROR event", fd_event->getFd())
-            // 删除出错的套接字
-            deleteEpollEvent(fd_event);
-            if (fd_event->handler(FdEvent::ERROR_EVENT) != nullptr)
-            {
-              DEBUGLOG("fd %d add error callback", fd_event->getFd())
-              addTask(fd_event->handler(FdEvent::OUT_EVENT));
-            }
-          }
+          handleEvent(m_result_events[i]);
+        }
+
+        // 返回的事件把数组填满了，说明还有就绪事件没取到，扩容让下一轮一次取完
+        if (rt == (int)m_result_events.size() && m_result_events.size() < (size_t)g_epoll_max_events)
+        {
+          m_result_events.resize(std::min(m_result_events.size() * 2, (size_t)g_epoll_max_events));
         }
       }
     }
+    Clock::Invalidate();
+  }
+
+  bool EventLoop::runTasks()
+  {
+    bool has_backlog = false;
+    size_t task_count = 0;
+    int64_t run_count = 0;
+    for (int lane = 0; lane < TaskPriorityCount; ++lane)
+    {
+      std::vector<std::function<void()>> &tasks = m_lane_tasks[lane];
+      size_t &cursor = m_lane_cursor[lane];
+      task_count += m_pending_tasks[lane].popAll(tasks);
+
+      int64_t deadline = 0;
+      if (g_task_lane_budget_us[lane] > 0 && cursor < tasks.size())
+      {
+        deadline = Clock::FastUs() + g_task_lane_budget_us[lane];
+      }
+      while (cursor < tasks.size())
+      {
+        std::function<void()> cb;
+        cb.swap(tasks[cursor++]);
+        ++run_count;
+        if (cb)
+        {
+          runHandler(cb);
+        }
+        // 每轮至少执行一个任务，保证低优先级不会被饿死
+        if (deadline > 0 && Clock::FastUs() >= deadline)
+        {
+          break;
+        }
+      }
+
+      if (cursor == tasks.size())
+      {
+        tasks.clear();
+        cursor = 0;
+      }
+      else
+      {
+        has_backlog = true;
+      }
+    }
+
+    EventLoopStats::Increase(m_stats.m_loop_count, 1);
+    EventLoopStats::Increase(m_stats.m_task_count, task_count);
+    if (run_count > 0)
+    {
+      m_stats.m_pending_task_count.fetch_sub(run_count, std::memory_order_relaxed);
+    }
+    m_stats.m_pending_tasks.record(task_count);
+    return has_backlog;
+  }
+
+  int EventLoop::pollEvents(int timeout)
+  {
+    // 还有积压任务时 timeout 为 0，不需要空转
+    if (m_busy_poll_us <= 0 || timeout == 0)
+    {
+      return m_poller->poll(m_result_events, timeout);
+    }
+
+    // 密度只统计空转窗口内等到的事件：忙轮询时就是空转的结果，空转没等到事件记一次 0，
+    // 之后阻塞 poll 拿到的事件不计入；阻塞等待时只有在 spin_us 之内返回的事件才计入。
+    // 否则稀疏但每次醒来都有事件的负载（比如 100ms 一个请求）密度一直在 1 附近，会一直空转占满一个核
+    int rt = 0;
+    if (m_is_busy_polling)
+    {
+      // 空转期间其他线程 addTask 会写 eventfd，同样能把 loop 从空转里拉出来
+      int64_t deadline = Clock::FastUs() + m_busy_poll_us;
+      do
+      {
+        rt = m_poller->poll(m_result_events, 0);
+      } while (rt == 0 && !m_stop_flag && Clock::FastUs() < deadline);
+      updateEventDensity(rt > 0 ? rt : 0);
+
+      if (rt == 0 && !m_stop_flag)
+      {
+        rt = m_poller->poll(m_result_events, timeout);
+      }
+      return rt;
+    }
+
+    int64_t start = Clock::FastUs();
+    rt = m_poller->poll(m_result_events, timeout);
+    updateEventDensity(rt > 0 && Clock::FastUs() - start <= m_busy_poll_us ? rt : 0);
+    return rt;
+  }
+
+  void EventLoop::updateEventDensity(int events)
+  {
+    // alpha = 1/8，负载下降后很快退回阻塞
+    m_event_density += (events - m_event_density) / 8;
+    if (!m_is_busy_polling && m_event_density >= m_busy_poll_density)
+    {
+      m_is_busy_polling = true;
+      DEBUGLOG("event density %.2f, switch to busy poll", m_event_density);
+    }
+    else if (m_is_busy_polling && m_event_density < m_busy_poll_density / 2)
+    {
+      m_is_busy_polling = false;
+      DEBUGLOG("event density %.2f, switch to blocking poll", m_event_density);
+    }
+  }
+
+  void EventLoop::handleEvent(const epoll_event &trigger_event)
+  {
+    FdEvent *fd_event = static_cast<FdEvent *>(trigger_event.data.ptr);
+    if (fd_event == NULL)
+    {
+      ERRORLOG("fd_event = NULL, continue");
+      return;
+    }
+
+    // int event = (int)(trigger_event.events);
+    // DEBUGLOG("unkonow event = %d", event);
+
+    if (trigger_event.events & EPOLLIN)
+    {
+      // DEBUGLOG("fd %d trigger EPOLLIN event", fd_event->getFd())
+      dispatchHandler(fd_event->handler(FdEvent::IN_EVENT));
+    }
+    if (trigger_event.events & EPOLLOUT)
+    {
+      // DEBUGLOG("fd %d trigger EPOLLOUT event", fd_event->getFd())
+      dispatchHandler(fd_event->handler(FdEvent::OUT_EVENT));
+    }
+
+    // EPOLLHUP EPOLLERR
+    if (trigger_event.events & EPOLLERR)
+    {
+      DEBUGLOG("fd %d trigger EPOLLERROR event", fd_event->getFd())
+      // 删除出错的套接字
+      deleteEpollEvent(fd_event);
+      std::function<void()> error_callback = fd_event->handler(FdEvent::ERROR_EVENT);
+      if (error_callback != nullptr)
+      {
+        DEBUGLOG("fd %d add error callback", fd_event->getFd())
+        dispatchHandler(error_callback);
+      }
+    }
+  }
+
+  void EventLoop::dispatchHandler(std::function<void()> cb)
+  {
+    if (!cb)
+    {
+      return;
+    }
+    // 内联模式下直接在 epoll 结果循环里执行，否则和以前一样放到下一轮的任务队列
+    if (m_is_inline_dispatch)
+    {
+      runHandler(cb);
+    }
+    else
+    {
+      addTask(std::move(cb));
+    }
+  }
+
+  void EventLoop::runHandler(const std::function<void()> &cb)
+  {
+    int64_t begin = Clock::FastUs();
+    cb();
+    int64_t cost = Clock::FastUs() - begin;
+    EventLoopStats::Increase(m_stats.m_callback_time_us, cost);
+    m_stats.m_handler_us.record(cost);
   }
 
   void EventLoop::wakeup()
@@ -217,13 +447,13 @@ namespace rocket
   {
     if (isInLoopThread())
     {
-      ADD_TO_EPOLL();
+      m_poller->addEvent(event);
     }
     else
     {
       auto cb = [this, event]()
       {
-        ADD_TO_EPOLL();
+        m_poller->addEvent(event);
       };
       addTask(cb, true);
     }
@@ -233,31 +463,71 @@ namespace rocket
   {
     if (isInLoopThread())
     {
-      DELETE_TO_EPOLL();
+      m_poller->deleteEvent(event);
     }
     else
     {
-
       auto cb = [this, event]()
       {
-        DELETE_TO_EPOLL();
+        m_poller->deleteEvent(event);
       };
       addTask(cb, true);
     }
   }
 
-  void EventLoop::addTask(std::function<void()> cb, bool is_wake_up /*=false*/)
+  void EventLoop::addTask(std::function<void()> cb, bool is_wake_up /*=false*/, TaskPriority priority /*=TaskPriorityIO*/)
   {
-    ScopeMutex<Mutex> lock(m_mutex);
-    m_pending_tasks.push(cb);
-    lock.unlock();
+    if (priority < 0 || priority >= TaskPriorityCount)
+    {
+      priority = TaskPriorityIO;
+    }
+    m_pending_tasks[priority].push(std::move(cb));
+    m_stats.m_pending_task_count.fetch_add(1, std::memory_order_relaxed);
 
-    if (is_wake_up)
+    // 只有第一个把标志从 false 改成 true 的生产者才真正写 eventfd
+    if (is_wake_up && !m_wakeup_pending.exchange(true))
     {
       wakeup();
     }
   }
 
+  void EventLoop::runInLoop(std::function<void()> cb)
+  {
+    if (isInLoopThread())
+    {
+      cb();
+    }
+    else
+    {
+      addTask(std::move(cb), true);
+    }
+  }
+
+  void EventLoop::setInlineDispatch(bool value)
+  {
+    m_is_inline_dispatch = value;
+  }
+
+  bool EventLoop::isInlineDispatch()
+  {
+    return m_is_inline_dispatch;
+  }
+
+  void EventLoop::setBusyPoll(int spin_us, double density)
+  {
+    runInLoop([this, spin_us, density]()
+              {
+    m_busy_poll_us = spin_us > 0 ? spin_us : 0;
+    m_busy_poll_density = density > 0 ? density : 0.5;
+    m_is_busy_polling = false;
+    INFOLOG("event loop busy poll %d us, density threshold %.2f", m_busy_poll_us, m_busy_poll_density); });
+  }
+
+  const EventLoopStats &EventLoop::getStats()
+  {
+    return m_stats;
+  }
+
   bool EventLoop::isInLoopThread()
   {
     return getThreadId() == m_thread_id;
@@ -273,9 +543,19 @@ namespace rocket
     return t_current_eventloop;
   }
 
+  void EventLoop::updateConnectionCount(int delta)
+  {
+    m_stats.m_connections.fetch_add(delta, std::memory_order_relaxed);
+  }
+
   bool EventLoop::isLooping()
   {
     return m_is_looping;
   }
 
+  Poller *EventLoop::getPoller()
+  {
+    return m_poller;
+  }
+
 }
@@ -5,13 +5,62 @@
 #include <set>
 #include <functional>
 #include <queue>
+#include <atomic>
+#include <vector>
 #include "rocket/common/mutex.h"
 #include "rocket/net/fd_event.h"
 #include "rocket/net/wakeup_fd_event.h"
 #include "rocket/net/timer.h"
+#include "rocket/net/eventloop_stats.h"
+#include "rocket/net/task_priority.h"
 
 namespace rocket
 {
+
+  /// @brief 有界无锁多生产者单消费者任务队列
+  /// 环形数组的每个槽位带一个序号，生产者通过 CAS 抢占写位置，只有 loop 线程消费。
+  /// 环满之后任务转入加锁的溢出队列，保证 addTask 永远不会失败；一旦溢出队列非空，
+  /// 后续任务继续进入溢出队列，直到 loop 线程把它取走，以保持同一生产者的 FIFO 顺序。
+  class MpscTaskQueue
+  {
+  public:
+    // capacity 会向上取整为 2 的幂
+    MpscTaskQueue(size_t capacity = 4096);
+
+    ~MpscTaskQueue();
+
+    // 任意线程调用
+    void push(std::function<void()> cb);
+
+    // 只允许 loop 线程调用，把当前所有任务追加到 tasks 的末尾，返回取出的任务数
+    size_t popAll(std::vector<std::function<void()>> &tasks);
+
+  private:
+    bool tryPush(std::function<void()> &cb);
+
+  private:
+    struct Cell
+    {
+      std::atomic<size_t> m_sequence;
+      std::function<void()> m_task;
+    };
+
+    Cell *m_cells{NULL};
+    size_t m_mask{0};
+
+    // 生产者和消费者的位置用填充隔开到不同的 cache line，避免伪共享
+    char m_pad0[64];
+    std::atomic<size_t> m_enqueue_pos{0};
+    char m_pad1[64];
+    size_t m_dequeue_pos{0};
+
+    std::atomic<bool> m_has_overflow{false};
+    std::queue<std::function<void()>> m_overflow_tasks;
+    Mutex m_overflow_mutex;
+  };
+
+  class Poller;
+
   class EventLoop
   {
   public:
@@ -31,12 +80,38 @@ namespace rocket
 
     bool isInLoopThread();
 
-    void addTask(std::function<void()> cb, bool is_wake_up = false);
+    // 每个优先级一条任务队列，每轮 loop 先执行高优先级的，低优先级的队列有单轮时间预算，
+    // 超出预算剩下的任务留到下一轮（此时 poll 不阻塞）
+    void addTask(std::function<void()> cb, bool is_wake_up = false, TaskPriority priority = TaskPriorityIO);
+
+    // 在 loop 线程里调用时立即执行，否则作为任务投递并唤醒 loop
+    void runInLoop(std::function<void()> cb);
+
+    // true: IN/OUT/ERR 回调直接在 epoll 结果循环里执行（默认）
+    // false: 回调先放入任务队列，下一轮 loop 再执行
+    void setInlineDispatch(bool value);
+
+    bool isInlineDispatch();
+
+    // 自适应忙轮询：最近的事件密度（每轮 loop 在 spin_us 之内等到的就绪事件数的滑动平均）不低于 density 时，
+    // 阻塞之前先用 timeout=0 空转 spin_us 微秒；密度降到一半以下后退回阻塞等待。spin_us 为 0 时关闭
+    void setBusyPoll(int spin_us, double density);
 
     void addTimerEvent(TimerEvent::s_ptr event);
 
+    void deleteTimerEvent(TimerEvent::s_ptr event);
+
     bool isLooping();
 
+    // loop 线程写入，任意线程可读
+    const EventLoopStats &getStats();
+
+    // 服务端连接挂到这个 loop 上时 +1，关闭时 -1，供连接放置策略使用
+    void updateConnectionCount(int delta);
+
+    // 只允许在 loop 线程里使用
+    Poller *getPoller();
+
   public:
     static EventLoop *GetCurrentEventLoop();
 
@@ -47,10 +122,25 @@ namespace rocket
 
     void initTimer();
 
+    void handleEvent(const epoll_event &trigger_event);
+
+    void dispatchHandler(std::function<void()> cb);
+
+    // 执行回调并统计耗时
+    void runHandler(const std::function<void()> &cb);
+
+    // 按优先级执行任务，还有任务因为预算没执行完时返回 true
+    bool runTasks();
+
+    int pollEvents(int timeout);
+
+    // 记一次密度样本，按阈值切换忙轮询 / 阻塞等待
+    void updateEventDensity(int events);
+
   private:
     pid_t m_thread_id{0};
 
-    int m_epoll_fd{0};
+    Poller *m_poller{NULL}; // epoll 或 io_uring，由配置决定
 
     int m_wakeup_fd{0};
 
@@ -58,17 +148,31 @@ namespace rocket
 
     bool m_stop_flag{false};
 
-    std::set<int> m_listen_fds;
+    MpscTaskQueue m_pending_tasks[TaskPriorityCount];
 
-    std::queue<std::function<void()>> m_pending_tasks;
+    // 每个优先级已经取出、还没执行完的任务，以及下一个要执行的下标
+    std::vector<std::function<void()>> m_lane_tasks[TaskPriorityCount];
+    size_t m_lane_cursor[TaskPriorityCount] = {0};
 
-    Mutex m_mutex;
+    // 已经写过 eventfd 但 loop 还没处理的标志，多个生产者在一轮 loop 里最多触发一次 wakeup
+    std::atomic<bool> m_wakeup_pending{false};
 
     Timer *m_timer{NULL};
 
     bool m_is_looping{false};
+
+    bool m_is_inline_dispatch{true};
+
+    std::vector<epoll_event> m_result_events; // poll 的结果数组，就绪事件填满时翻倍
+
+    int m_busy_poll_us{0};             // 每次阻塞前的最长空转时间
+    double m_busy_poll_density{0.5};   // 进入忙轮询的事件密度阈值
+    double m_event_density{0};         // 每轮就绪事件数的 EWMA
+    bool m_is_busy_polling{false};
+
+    EventLoopStats m_stats;
   };
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include "rocket/net/eventloop_stats.h"
+
+namespace rocket
+{
+
+  LatencyHistogram::LatencyHistogram()
+  {
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+      m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  void LatencyHistogram::record(int64_t value)
+  {
+    int index = 0;
+    if (value > 0)
+    {
+      index = 64 - __builtin_clzll((uint64_t)value);
+      if (index >= BUCKET_COUNT)
+      {
+        index = BUCKET_COUNT - 1;
+      }
+    }
+
+    m_buckets[index].store(m_buckets[index].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    m_sum.store(m_sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    if (value > m_max.load(std::memory_order_relaxed))
+    {
+      m_max.store(value, std::memory_order_relaxed);
+    }
+    // count 最后写，读端看到的 count 不会超过桶里的总数太多
+    m_count.store(m_count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  uint64_t LatencyHistogram::count() const
+  {
+    return m_count.load(std::memory_order_acquire);
+  }
+
+  int64_t LatencyHistogram::sum() const
+  {
+    return m_sum.load(std::memory_order_relaxed);
+  }
+
+  int64_t LatencyHistogram::max() const
+  {
+    return m_max.load(std::memory_order_relaxed);
+  }
+
+  uint64_t LatencyHistogram::bucket(int index) const
+  {
+    if (index < 0 || index >= BUCKET_COUNT)
+    {
+      return 0;
+    }
+    return m_buckets[index].load(std::memory_order_relaxed);
+  }
+
+  int64_t LatencyHistogram::percentile(double p) const
+  {
+    uint64_t total = 0;
+    uint64_t buckets[BUCKET_COUNT];
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+      buckets[i] = bucket(i);
+      total += buckets[i];
+    }
+    if (total == 0)
+    {
+      return 0;
+    }
+
+    uint64_t target = (uint64_t)(total * p / 100);
+    if (target >= total)
+    {
+      target = total - 1;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+      seen += buckets[i];
+      if (seen > target)
+      {
+        if (i == 0)
+        {
+          return 0;
+        }
+        return i == BUCKET_COUNT - 1 ? max() : ((int64_t)1 << i) - 1;
+      }
+    }
+    return max();
+  }
+
+  std::string LatencyHistogram::toString() const
+  {
+    uint64_t n = count();
+    char buf[256];
+    snprintf(buf, sizeof(buf), "count=%llu avg=%lld p50<=%lld p99<=%lld p999<=%lld max=%lld",
+             (unsigned long long)n, (long long)(n ? sum() / (int64_t)n : 0), (long long)percentile(50),
+             (long long)percentile(99), (long long)percentile(99.9), (long long)max());
+    return buf;
+  }
+
+  std::string EventLoopStats::toString() const
+  {
+    char buf[256];
+    snprintf(buf, sizeof(buf), "loops=%llu events=%llu tasks=%llu poll_time=%lluus callback_time=%lluus",
+             (unsigned long long)m_loop_count.load(std::memory_order_relaxed),
+             (unsigned long long)m_event_count.load(std::memory_order_relaxed),
+             (unsigned long long)m_task_count.load(std::memory_order_relaxed),
+             (unsigned long long)m_poll_time_us.load(std::memory_order_relaxed),
+             (unsigned long long)m_callback_time_us.load(std::memory_order_relaxed));
+
+    std::string re(buf);
+    snprintf(buf, sizeof(buf), " connections=%lld pending_tasks=%lld loop_lag=%lldus",
+             (long long)m_connections.load(std::memory_order_relaxed),
+             (long long)m_pending_task_count.load(std::memory_order_relaxed),
+             (long long)m_loop_lag_us.load(std::memory_order_relaxed));
+    re += buf;
+    re += "\n  poll_wait_us: " + m_poll_wait_us.toString();
+    re += "\n  events_per_wakeup: " + m_events_per_wakeup.toString();
+    re += "\n  pending_tasks: " + m_pending_tasks.toString();
+    re += "\n  handler_us: " + m_handler_us.toString();
+    re += "\n  timer_lateness_us: " + m_timer_lateness_us.toString();
+    return re;
+  }
+
+}
@@ -0,0 +1,77 @@
+#ifndef ROCKET_NET_EVENTLOOP_STATS_H
+#define ROCKET_NET_EVENTLOOP_STATS_H
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+
+namespace rocket
+{
+
+  /// @brief 按 2 的幂分桶的直方图
+  /// 只允许一个线程写（所属 loop 线程），写端用 relaxed 的 load + store，没有原子 RMW 和锁；
+  /// 任意线程都可以读，读到的是近似一致的快照。
+  class LatencyHistogram
+  {
+  public:
+    // 第 0 个桶放 <= 0 的值，第 i 个桶放 [2^(i-1), 2^i)，最后一个桶放剩下所有更大的值
+    static const int BUCKET_COUNT = 40;
+
+    LatencyHistogram();
+
+    void record(int64_t value);
+
+    uint64_t count() const;
+
+    int64_t sum() const;
+
+    int64_t max() const;
+
+    uint64_t bucket(int index) const;
+
+    // 第 p 分位所在桶的上界，p 取 [0, 100]
+    int64_t percentile(double p) const;
+
+    std::string toString() const;
+
+  private:
+    std::atomic<uint64_t> m_buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<int64_t> m_sum{0};
+    std::atomic<int64_t> m_max{0};
+  };
+
+  /// @brief 一个 EventLoop 的运行统计，由 loop 线程写，其他线程通过 EventLoop::getStats() 读
+  class EventLoopStats
+  {
+  public:
+    // 单写者的计数器累加
+    static void Increase(std::atomic<uint64_t> &counter, uint64_t value)
+    {
+      counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    std::string toString() const;
+
+  public:
+    std::atomic<uint64_t> m_loop_count{0};       // loop 轮数
+    std::atomic<uint64_t> m_event_count{0};      // 处理的就绪事件总数
+    std::atomic<uint64_t> m_task_count{0};       // 执行的任务总数
+    std::atomic<uint64_t> m_poll_time_us{0};     // 花在 poll 等待里的总时间
+    std::atomic<uint64_t> m_callback_time_us{0}; // 花在 IO 回调、任务、定时任务里的总时间
+
+    // 实时负载，IOThreadGroup 的连接放置策略使用
+    std::atomic<int64_t> m_connections{0};        // 当前挂在这个 loop 上的服务端连接数
+    std::atomic<int64_t> m_pending_task_count{0}; // 已经投递还没执行的任务数，任意线程都会写
+    std::atomic<int64_t> m_loop_lag_us{0};        // 每轮 loop 在 poll 之外花掉的时间的 EWMA
+
+    LatencyHistogram m_poll_wait_us;       // 每次 poll 的耗时
+    LatencyHistogram m_events_per_wakeup;  // 每次 poll 返回的就绪事件数
+    LatencyHistogram m_pending_tasks;      // 每轮取任务时队列里的任务数
+    LatencyHistogram m_handler_us;         // 每个回调/任务的执行时间
+    LatencyHistogram m_timer_lateness_us;  // 定时任务实际执行时间 - TimerEvent::getArriveTime()
+  };
+
+}
+
+#endif
@@ -74,6 +74,40 @@ namespace rocket
     }
   }
 
+  void FdEvent::setEdgeTriggered(bool value)
+  {
+    if (value)
+    {
+      m_listen_events.events |= EPOLLET;
+    }
+    else
+    {
+      m_listen_events.events &= (~EPOLLET);
+    }
+  }
+
+  bool FdEvent::isEdgeTriggered() const
+  {
+    return m_listen_events.events & EPOLLET;
+  }
+
+  void FdEvent::setOneShot(bool value)
+  {
+    if (value)
+    {
+      m_listen_events.events |= EPOLLONESHOT;
+    }
+    else
+    {
+      m_listen_events.events &= (~EPOLLONESHOT);
+    }
+  }
+
+  bool FdEvent::isOneShot() const
+  {
+    return m_listen_events.events & EPOLLONESHOT;
+  }
+
   void FdEvent::setNonBlock()
   {
 
@@ -32,6 +32,27 @@ namespace rocket
     // 取消监听
     void cancle(TriggerEvent event_type);
 
+    // 边缘触发，回调需要一直读写到 EAGAIN
+    void setEdgeTriggered(bool value);
+
+    bool isEdgeTriggered() const;
+
+    // 触发一次后 epoll 不再通知，直到重新 addEpollEvent（EPOLL_CTL_MOD）
+    void setOneShot(bool value);
+
+    bool isOneShot() const;
+
+    // 读写交给 Poller 以完成事件的方式执行，后端不支持时不起作用
+    void setAsyncIo(bool value)
+    {
+      m_async_io = value;
+    }
+
+    bool isAsyncIo() const
+    {
+      return m_async_io;
+    }
+
     int getFd() const
     {
       return m_fd;
@@ -47,6 +68,8 @@ namespace rocket
 
     epoll_event m_listen_events;
 
+    bool m_async_io{false};
+
     std::function<void()> m_read_callback{nullptr};
     std::function<void()> m_write_callback{nullptr};
     std::function<void()> m_error_callback{nullptr};
@@ -1,14 +1,18 @@
 
 #include <pthread.h>
 #include <assert.h>
+#include <errno.h>
+#include <string.h>
 #include "rocket/net/io_thread.h"
 #include "rocket/common/log.h"
 #include "rocket/common/util.h"
+#include "rocket/common/cpu_affinity.h"
 
 namespace rocket
 {
 
-  IOThread::IOThread()
+  IOThread::IOThread(const std::vector<int> &cpus /*= std::vector<int>()*/, bool numa_local /*= false*/)
+      : m_cpus(cpus), m_numa_local(numa_local)
   {
 
     int rt = sem_init(&m_init_semaphore, 0, 0);
@@ -44,9 +48,23 @@ namespace rocket
   void *IOThread::Main(void *arg)
   {
     IOThread *thread = static_cast<IOThread *>(arg);
+    thread->m_thread_id = getThreadId();
+
+    // 先绑核再创建 EventLoop，loop 以及之后在本线程创建的对象才会分配在本地 NUMA 节点上
+    if (!bindCurrentThreadToCpus(thread->m_cpus))
+    {
+      ERRORLOG("IOThread %d bind to cpus [%s] error, errno=%d, error=%s", thread->m_thread_id, cpuListToString(thread->m_cpus).c_str(), errno, strerror(errno));
+    }
+    else if (!thread->m_cpus.empty())
+    {
+      INFOLOG("IOThread %d bind to cpus [%s]", thread->m_thread_id, cpuListToString(thread->m_cpus).c_str());
+    }
+    if (thread->m_numa_local && !setNumaLocalPolicy())
+    {
+      ERRORLOG("IOThread %d set numa local memory policy error, errno=%d, error=%s", thread->m_thread_id, errno, strerror(errno));
+    }
 
     thread->m_event_loop = new EventLoop();
-    thread->m_thread_id = getThreadId();
 
     // 唤醒等待的线程
     sem_post(&thread->m_init_semaphore);
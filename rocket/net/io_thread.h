@@ -3,6 +3,7 @@
 
 #include <pthread.h>
 #include <semaphore.h>
+#include <vector>
 #include "rocket/net/eventloop.h"
 
 namespace rocket
@@ -11,7 +12,8 @@ namespace rocket
   class IOThread
   {
   public:
-    IOThread();
+    // cpus 不为空时线程先绑核再创建 EventLoop，numa_local 为 true 时 loop、连接和缓冲区都从本 NUMA 节点分配
+    IOThread(const std::vector<int> &cpus = std::vector<int>(), bool numa_local = false);
 
     ~IOThread();
 
@@ -30,6 +32,9 @@ namespace rocket
 
     EventLoop *m_event_loop{NULL}; // 当前 io 线程的 loop 对象
 
+    std::vector<int> m_cpus; // 绑定的 cpu，为空表示不绑定
+    bool m_numa_local{false};
+
     sem_t m_init_semaphore;
 
     sem_t m_start_semaphore;
@@ -1,20 +1,44 @@
 #include "rocket/net/io_thread_group.h"
 #include "rocket/common/log.h"
+#include "rocket/common/config.h"
+#include "rocket/net/placement_policy.h"
 
 namespace rocket
 {
 
   IOThreadGroup::IOThreadGroup(int size) : m_size(size)
   {
+    std::vector<std::vector<int>> cpu_sets;
+    bool numa_local = false;
+    std::string placement = "round_robin";
+    if (Config::GetGlobalConfig())
+    {
+      cpu_sets = Config::GetGlobalConfig()->m_io_thread_cpus;
+      numa_local = Config::GetGlobalConfig()->m_numa_local;
+      placement = Config::GetGlobalConfig()->m_placement;
+    }
+    m_placement_policy = PlacementPolicy::CreatePlacementPolicy(placement);
+    INFOLOG("IOThreadGroup use placement policy [%s]", m_placement_policy->name());
+
     m_io_thread_groups.resize(size);
     for (size_t i = 0; (int)i < size; ++i)
     {
-      m_io_thread_groups[i] = new IOThread();
+      std::vector<int> cpus;
+      if (!cpu_sets.empty())
+      {
+        cpus = cpu_sets[i % cpu_sets.size()];
+      }
+      m_io_thread_groups[i] = new IOThread(cpus, numa_local);
     }
   }
 
   IOThreadGroup::~IOThreadGroup()
   {
+    if (m_placement_policy)
+    {
+      delete m_placement_policy;
+      m_placement_policy = NULL;
+    }
   }
 
   void IOThreadGroup::start()
@@ -33,15 +57,44 @@ namespace rocket
     }
   }
 
-  /// @brief 获取随机的IOthread
+  /// @brief 按放置策略选一个 IO 线程
+  /// @param peer_addr 新连接的对端地址，可以为空
   /// @return 
-  IOThread *IOThreadGroup::getIOThread()
+  IOThread *IOThreadGroup::getIOThread(NetAddr::s_ptr peer_addr /*= nullptr*/)
+  {
+    return m_placement_policy->select(m_io_thread_groups, peer_addr);
+  }
+
+  int IOThreadGroup::size()
+  {
+    return m_size;
+  }
+
+  IOThread *IOThreadGroup::getIOThreadAt(int index)
   {
-    if (m_index == (int)m_io_thread_groups.size() || m_index == -1)
+    return m_io_thread_groups[index];
+  }
+
+  void IOThreadGroup::setPlacementPolicy(PlacementPolicy *policy)
+  {
+    if (!policy)
+    {
+      return;
+    }
+    if (m_placement_policy)
+    {
+      delete m_placement_policy;
+    }
+    m_placement_policy = policy;
+    INFOLOG("IOThreadGroup use placement policy [%s]", policy->name());
+  }
+
+  void IOThreadGroup::setBusyPoll(int spin_us, double density)
+  {
+    for (size_t i = 0; i < m_io_thread_groups.size(); ++i)
     {
-      m_index = 0;
+      m_io_thread_groups[i]->getEventLoop()->setBusyPoll(spin_us, density);
     }
-    return m_io_thread_groups[m_index++];
   }
 
 }
\ No newline at end of file
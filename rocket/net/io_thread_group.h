@@ -4,10 +4,13 @@
 #include <vector>
 #include "rocket/common/log.h"
 #include "rocket/net/io_thread.h"
+#include "rocket/net/tcp/net_addr.h"
 
 namespace rocket
 {
 
+  class PlacementPolicy;
+
   class IOThreadGroup
   {
 
@@ -20,13 +23,24 @@ namespace rocket
 
     void join();
 
-    IOThread *getIOThread();
+    // 按放置策略为新连接选一个 IO 线程，peer_addr 给 peer_hash 策略使用
+    IOThread *getIOThread(NetAddr::s_ptr peer_addr = nullptr);
+
+    int size();
+
+    IOThread *getIOThreadAt(int index);
+
+    // 替换放置策略，group 接管 policy 的所有权；默认策略取自 <io_thread_group><placement>
+    void setPlacementPolicy(PlacementPolicy *policy);
+
+    // 组内所有 IO 线程的自适应忙轮询参数，见 EventLoop::setBusyPoll
+    void setBusyPoll(int spin_us, double density);
 
   private:
     int m_size{0};
     std::vector<IOThread *> m_io_thread_groups;
 
-    int m_index{0};
+    PlacementPolicy *m_placement_policy{NULL};
   };
 
 }
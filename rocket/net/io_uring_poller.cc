@@ -0,0 +1,759 @@
+#include <unistd.h>
+#include <algorithm>
+#include <string.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "rocket/net/io_uring_poller.h"
+#include "rocket/common/log.h"
+
+namespace rocket
+{
+
+  static unsigned g_io_uring_entries = 256;
+
+  // 删除 poll、超时等不需要处理的完成事件使用的 user_data，正常 poll 的 token 从 1 开始
+  static const uint64_t g_ignore_user_data = 0;
+
+  static const uint32_t g_trigger_flags = EPOLLET | EPOLLONESHOT;
+
+  // poll 连续以错误完成超过这个次数就不再重试
+  static const int g_max_poll_retry = 3;
+
+  // 注册缓冲区切成的槽位，一个正在读的 fd 占一个
+  static const int g_read_slot_size = 16 * 1024;
+  static const int g_read_slot_count = 128;
+
+  // user_data 的高 2 位是操作类型，中间 30 位是 fd（读是槽位号），低 32 位是 token
+  enum UringOp
+  {
+    UringOpPoll = 0,
+    UringOpRead = 1,
+    UringOpWrite = 2,
+  };
+
+  static uint64_t makeUserData(UringOp op, int index, uint32_t token)
+  {
+    return ((uint64_t)op << 62) | ((uint64_t)((uint32_t)index & 0x3fffffff) << 32) | token;
+  }
+
+  IoUringPoller::IoUringPoller()
+  {
+    if (!initRing())
+    {
+      ERRORLOG("failed to init io_uring, errno=%d, error=%s", errno, strerror(errno));
+    }
+  }
+
+  IoUringPoller::~IoUringPoller()
+  {
+    if (m_read_slab)
+    {
+      munmap(m_read_slab, m_read_slab_size);
+    }
+    if (m_sqes)
+    {
+      munmap(m_sqes, m_sqes_size);
+    }
+    if (m_cq_ring_ptr && m_cq_ring_ptr != m_sq_ring_ptr)
+    {
+      munmap(m_cq_ring_ptr, m_cq_ring_size);
+    }
+    if (m_sq_ring_ptr)
+    {
+      munmap(m_sq_ring_ptr, m_sq_ring_size);
+    }
+    if (m_ring_fd != -1)
+    {
+      close(m_ring_fd);
+    }
+  }
+
+  bool IoUringPoller::isValid()
+  {
+    return m_ring_fd != -1;
+  }
+
+  bool IoUringPoller::initRing()
+  {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    int fd = (int)syscall(__NR_io_uring_setup, g_io_uring_entries, &params);
+    if (fd < 0)
+    {
+      return false;
+    }
+    m_ring_fd = fd;
+
+    m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap)
+    {
+      m_sq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+      m_cq_ring_size = m_sq_ring_size;
+    }
+
+    void *sq_ptr = mmap(NULL, m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sq_ptr == MAP_FAILED)
+    {
+      return false;
+    }
+    m_sq_ring_ptr = sq_ptr;
+
+    void *cq_ptr = sq_ptr;
+    if (!single_mmap)
+    {
+      cq_ptr = mmap(NULL, m_cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+      if (cq_ptr == MAP_FAILED)
+      {
+        return false;
+      }
+    }
+    m_cq_ring_ptr = cq_ptr;
+
+    m_sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(NULL, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+      return false;
+    }
+    m_sqes = static_cast<struct io_uring_sqe *>(sqes);
+
+    char *sq = static_cast<char *>(sq_ptr);
+    m_sq_entries = params.sq_entries;
+    m_sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    m_sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    m_sq_mask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    m_sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+
+    char *cq = static_cast<char *>(cq_ptr);
+    m_cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    m_cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    m_cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+
+    m_multishot_poll = probeMultishotPoll();
+    m_async_io = initReadSlab();
+
+    INFOLOG("succ init io_uring, ring fd[%d], sq entries[%u], cq entries[%u], multishot poll[%d], async io[%d]", fd, params.sq_entries, params.cq_entries, m_multishot_poll, m_async_io);
+    return true;
+  }
+
+  bool IoUringPoller::initReadSlab()
+  {
+    m_read_slab_size = (size_t)g_read_slot_size * g_read_slot_count;
+    void *slab = mmap(NULL, m_read_slab_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (slab == MAP_FAILED)
+    {
+      return false;
+    }
+    m_read_slab = static_cast<char *>(slab);
+
+    // 注册的内存计入 RLIMIT_MEMLOCK，超出限制时只用 poll
+    struct iovec vec;
+    vec.iov_base = m_read_slab;
+    vec.iov_len = m_read_slab_size;
+    if (syscall(__NR_io_uring_register, m_ring_fd, IORING_REGISTER_BUFFERS, &vec, 1) != 0)
+    {
+      INFOLOG("io_uring register buffers failed, use poll only, errno=%d, error=%s", errno, strerror(errno));
+      munmap(m_read_slab, m_read_slab_size);
+      m_read_slab = NULL;
+      return false;
+    }
+
+    m_read_slot_fds.assign(g_read_slot_count, -1);
+    m_free_read_slots.reserve(g_read_slot_count);
+    for (int i = g_read_slot_count - 1; i >= 0; --i)
+    {
+      m_free_read_slots.push_back(i);
+    }
+    return true;
+  }
+
+  bool IoUringPoller::probeMultishotPoll()
+  {
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+      return false;
+    }
+
+    // 环还是空的，第一个完成事件就是这次 poll 的；5.13 之前的内核以 -EINVAL 完成
+    bool supported = false;
+    struct io_uring_sqe *sqe = getSqe();
+    if (sqe)
+    {
+      sqe->opcode = IORING_OP_POLL_ADD;
+      sqe->fd = fds[1];
+      sqe->poll32_events = EPOLLOUT;
+      sqe->len = IORING_POLL_ADD_MULTI;
+      sqe->user_data = g_ignore_user_data;
+      if (enter(1, 1, IORING_ENTER_GETEVENTS) >= 0)
+      {
+        unsigned head = *m_cq_head;
+        if (head != __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE))
+        {
+          struct io_uring_cqe *cqe = &m_cqes[head & *m_cq_mask];
+          supported = cqe->res >= 0 && (cqe->flags & IORING_CQE_F_MORE);
+          __atomic_store_n(m_cq_head, head + 1, __ATOMIC_RELEASE);
+        }
+      }
+    }
+
+    // 撤销还挂着的 poll，之后的完成事件 user_data 都是 g_ignore_user_data，poll() 里直接跳过
+    if (supported)
+    {
+      sqe = getSqe();
+      if (sqe)
+      {
+        sqe->opcode = IORING_OP_POLL_REMOVE;
+        sqe->fd = -1;
+        sqe->addr = g_ignore_user_data;
+        sqe->user_data = g_ignore_user_data;
+        enter(1, 0, 0);
+      }
+    }
+    close(fds[0]);
+    close(fds[1]);
+    return supported;
+  }
+
+  bool IoUringPoller::handlePollError(int fd, Entry &entry, int res)
+  {
+    ERRORLOG("io_uring poll fd[%d] error, res=%d, error=%s", fd, res, strerror(-res));
+    if (res == -EINVAL && entry.m_multishot)
+    {
+      // 探测之后仍然不支持 multishot，之后边缘触发都改用单次 poll
+      m_multishot_poll = false;
+      entry.m_multishot = false;
+    }
+    else if (res == -EBADF || ++entry.m_error_count > g_max_poll_retry)
+    {
+      return true;
+    }
+    // 这次 poll 没有真正触发过，ONESHOT 也要重新提交
+    m_rearm_fds.push_back(fd);
+    return false;
+  }
+
+  int IoUringPoller::enter(unsigned to_submit, unsigned min_complete, unsigned flags)
+  {
+    return (int)syscall(__NR_io_uring_enter, m_ring_fd, to_submit, min_complete, flags, NULL, 0);
+  }
+
+  struct io_uring_sqe *IoUringPoller::getSqe()
+  {
+    unsigned tail = *m_sq_tail;
+    unsigned head = __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+    if (tail - head >= m_sq_entries)
+    {
+      // SQ 写满了，先把已有的提交掉
+      if (enter(tail - head, 0, 0) < 0)
+      {
+        ERRORLOG("io_uring_enter submit error, errno=%d, error=%s", errno, strerror(errno));
+      }
+      head = __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+      if (tail - head >= m_sq_entries)
+      {
+        return NULL;
+      }
+    }
+
+    unsigned index = tail & *m_sq_mask;
+    struct io_uring_sqe *sqe = &m_sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    m_sq_array[index] = index;
+    __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+    return sqe;
+  }
+
+  void IoUringPoller::armEntry(int fd, Entry &entry)
+  {
+    struct io_uring_sqe *sqe = getSqe();
+    if (sqe == NULL)
+    {
+      ERRORLOG("io_uring sq is full, failed to poll fd[%d]", fd);
+      return;
+    }
+
+    entry.m_token = nextToken();
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = entry.m_events;
+    sqe->len = entry.m_multishot ? IORING_POLL_ADD_MULTI : 0;
+    sqe->user_data = makeUserData(UringOpPoll, fd, entry.m_token);
+    entry.m_armed = true;
+  }
+
+  uint32_t IoUringPoller::nextToken()
+  {
+    uint32_t token = m_next_token++;
+    if (m_next_token == 0)
+    {
+      m_next_token = 1;
+    }
+    return token;
+  }
+
+  void IoUringPoller::disarmEntry(int fd, Entry &entry)
+  {
+    if (!entry.m_armed)
+    {
+      return;
+    }
+    entry.m_armed = false;
+    uint32_t token = entry.m_token;
+    // 撤销之前已经产生的完成事件按 token 丢弃
+    entry.m_token = 0;
+
+    struct io_uring_sqe *sqe = getSqe();
+    if (sqe == NULL)
+    {
+      ERRORLOG("io_uring sq is full, failed to remove poll");
+      return;
+    }
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = makeUserData(UringOpPoll, fd, token);
+    sqe->user_data = g_ignore_user_data;
+  }
+
+  void IoUringPoller::submitCancel(uint64_t user_data)
+  {
+    struct io_uring_sqe *sqe = getSqe();
+    if (sqe == NULL)
+    {
+      ERRORLOG("io_uring sq is full, failed to cancel request");
+      return;
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = user_data;
+    sqe->user_data = g_ignore_user_data;
+  }
+
+  bool IoUringPoller::submitRead(int fd, Entry &entry)
+  {
+    if (m_free_read_slots.empty())
+    {
+      return false;
+    }
+    struct io_uring_sqe *sqe = getSqe();
+    if (sqe == NULL)
+    {
+      return false;
+    }
+
+    int slot = m_free_read_slots.back();
+    m_free_read_slots.pop_back();
+    m_read_slot_fds[slot] = fd;
+    entry.m_read_slot = slot;
+    entry.m_read_token = nextToken();
+    entry.m_reading = true;
+
+    sqe->opcode = IORING_OP_READ_FIXED;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)(m_read_slab + (size_t)slot * g_read_slot_size);
+    sqe->len = g_read_slot_size;
+    sqe->buf_index = 0;
+    sqe->user_data = makeUserData(UringOpRead, slot, entry.m_read_token);
+    return true;
+  }
+
+  void IoUringPoller::armRead(int fd, Entry &entry)
+  {
+    if (m_async_io && submitRead(fd, entry))
+    {
+      // 同时挂着读和可读的 poll 会让回调里的 read 抢在已经完成的读前面，打乱字节顺序
+      if (entry.m_events & EPOLLIN)
+      {
+        disarmEntry(fd, entry);
+        entry.m_events &= ~EPOLLIN;
+      }
+      return;
+    }
+    if (!m_async_io)
+    {
+      entry.m_async_read = false;
+    }
+    if (!(entry.m_events & EPOLLIN))
+    {
+      disarmEntry(fd, entry);
+      entry.m_events |= EPOLLIN;
+    }
+  }
+
+  void IoUringPoller::releaseReadSlot(int slot)
+  {
+    m_read_slot_fds[slot] = -1;
+    m_free_read_slots.push_back(slot);
+  }
+
+  void IoUringPoller::cancelRead(int fd, Entry &entry)
+  {
+    if (entry.m_reading)
+    {
+      // 槽位等撤销的完成事件回来之后才能给别人用
+      submitCancel(makeUserData(UringOpRead, entry.m_read_slot, entry.m_read_token));
+    }
+    else if (entry.m_read_ready)
+    {
+      releaseReadSlot(entry.m_read_slot);
+    }
+    entry.m_reading = false;
+    entry.m_read_ready = false;
+    entry.m_read_slot = -1;
+    entry.m_read_token = 0;
+  }
+
+  void IoUringPoller::cancelWrite(int fd, Entry &entry)
+  {
+    if (entry.m_writing)
+    {
+      // holder 在完成事件回来时释放
+      submitCancel(makeUserData(UringOpWrite, fd, entry.m_write_token));
+    }
+    entry.m_writing = false;
+    entry.m_write_ready = false;
+    entry.m_write_token = 0;
+  }
+
+  bool IoUringPoller::supportAsyncIo()
+  {
+    return m_async_io;
+  }
+
+  bool IoUringPoller::takeReadResult(FdEvent *event, const char *&data, int &res)
+  {
+    int fd = event->getFd();
+    if (fd < 0 || (size_t)fd >= m_entries.size() || !m_entries[fd].m_read_ready)
+    {
+      return false;
+    }
+    Entry &entry = m_entries[fd];
+    data = m_read_slab + (size_t)entry.m_read_slot * g_read_slot_size;
+    res = entry.m_read_res;
+
+    // 槽位要到下一次提交读时才会被复用，调用方在这之前拷走数据
+    releaseReadSlot(entry.m_read_slot);
+    entry.m_read_ready = false;
+    entry.m_read_slot = -1;
+    if (entry.m_one_shot)
+    {
+      // ONESHOT 等回调重新打开监听时再读
+      entry.m_async_read = false;
+    }
+    else if (res > 0)
+    {
+      m_rearm_fds.push_back(fd);
+    }
+    return true;
+  }
+
+  bool IoUringPoller::submitWrite(FdEvent *event, const struct iovec *vec, int count, std::shared_ptr<void> holder)
+  {
+    int fd = event->getFd();
+    if (!m_async_io || fd < 0 || (size_t)fd >= m_entries.size() || count <= 0)
+    {
+      return false;
+    }
+    Entry &entry = m_entries[fd];
+    if (!entry.m_registered || entry.m_writing || entry.m_write_ready)
+    {
+      return false;
+    }
+    struct io_uring_sqe *sqe = getSqe();
+    if (sqe == NULL)
+    {
+      return false;
+    }
+
+    entry.m_write_token = nextToken();
+    entry.m_writing = true;
+    uint64_t user_data = makeUserData(UringOpWrite, fd, entry.m_write_token);
+    PendingWrite &pending = m_pending_writes[user_data];
+    pending.m_vec.assign(vec, vec + count);
+    pending.m_holder = holder;
+
+    sqe->opcode = IORING_OP_WRITEV;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)pending.m_vec.data();
+    sqe->len = count;
+    sqe->user_data = user_data;
+    return true;
+  }
+
+  bool IoUringPoller::takeWriteResult(FdEvent *event, int &res)
+  {
+    int fd = event->getFd();
+    if (fd < 0 || (size_t)fd >= m_entries.size() || !m_entries[fd].m_write_ready)
+    {
+      return false;
+    }
+    Entry &entry = m_entries[fd];
+    res = entry.m_write_res;
+    entry.m_write_ready = false;
+    return true;
+  }
+
+  FdEvent *IoUringPoller::completeRead(int slot, uint32_t token, int res)
+  {
+    if (slot >= (int)m_read_slot_fds.size() || m_read_slot_fds[slot] < 0)
+    {
+      return NULL;
+    }
+    int fd = m_read_slot_fds[slot];
+    Entry &entry = m_entries[fd];
+    if (!entry.m_registered || !entry.m_reading || entry.m_read_slot != slot || entry.m_read_token != token)
+    {
+      // 已经撤销的读
+      releaseReadSlot(slot);
+      return NULL;
+    }
+    entry.m_reading = false;
+
+    if (res == -EAGAIN || res == -EINVAL || res == -EOPNOTSUPP)
+    {
+      // 老内核对非阻塞 socket 不等数据直接返回 EAGAIN，之后全部退回 poll
+      ERRORLOG("io_uring read fd[%d] not supported, res=%d, error=%s, fall back to poll", fd, res, strerror(-res));
+      m_async_io = false;
+      releaseReadSlot(slot);
+      entry.m_read_slot = -1;
+      armRead(fd, entry);
+      m_rearm_fds.push_back(fd);
+      return NULL;
+    }
+    if (res == -EINTR || res == -ECANCELED)
+    {
+      // 没有读到任何东西，换个槽位重新读
+      releaseReadSlot(slot);
+      entry.m_read_slot = -1;
+      m_rearm_fds.push_back(fd);
+      return NULL;
+    }
+
+    entry.m_read_ready = true;
+    entry.m_read_res = res;
+    return entry.m_event;
+  }
+
+  FdEvent *IoUringPoller::completeWrite(int fd, uint64_t user_data, int res)
+  {
+    m_pending_writes.erase(user_data);
+    if ((size_t)fd >= m_entries.size())
+    {
+      return NULL;
+    }
+    Entry &entry = m_entries[fd];
+    if (!entry.m_registered || !entry.m_writing || entry.m_write_token != (uint32_t)user_data)
+    {
+      return NULL;
+    }
+    entry.m_writing = false;
+    entry.m_write_ready = true;
+    entry.m_write_res = res;
+    return entry.m_event;
+  }
+
+  void IoUringPoller::addEvent(FdEvent *event)
+  {
+    int fd = event->getFd();
+    if (fd < 0)
+    {
+      return;
+    }
+    if ((size_t)fd >= m_entries.size())
+    {
+      m_entries.resize(fd + 1);
+    }
+
+    uint32_t listen_events = event->getEpollEvent().events;
+    uint32_t poll_events = listen_events & ~g_trigger_flags;
+    bool one_shot = listen_events & EPOLLONESHOT;
+    bool multishot = (listen_events & EPOLLET) && !one_shot && m_multishot_poll;
+
+    Entry &entry = m_entries[fd];
+    entry.m_registered = true;
+
+    // 异步读的 fd 可读时不用 poll，挂着的读完成就是可读；没有空闲槽位时这次还是 poll。
+    // 已经挂着或者读完的读即使后端刚关掉了异步读也要留着，撤销会丢掉里面的数据
+    bool async_read = event->isAsyncIo() && (poll_events & EPOLLIN) && (m_async_io || entry.m_reading || entry.m_read_ready);
+    if (async_read)
+    {
+      if (entry.m_reading || entry.m_read_ready || submitRead(fd, entry))
+      {
+        poll_events &= ~EPOLLIN;
+      }
+    }
+    else
+    {
+      cancelRead(fd, entry);
+    }
+    entry.m_async_read = async_read;
+
+    // 监听不变的水平/边缘触发 fd 已经在内核里，不需要重新提交
+    if (entry.m_armed && !one_shot && entry.m_event == event && entry.m_events == poll_events && entry.m_multishot == multishot)
+    {
+      return;
+    }
+
+    disarmEntry(fd, entry);
+    entry.m_event = event;
+    entry.m_events = poll_events;
+    entry.m_multishot = multishot;
+    entry.m_one_shot = one_shot;
+
+    if (poll_events & (EPOLLIN | EPOLLOUT))
+    {
+      armEntry(fd, entry);
+    }
+    DEBUGLOG("add event success, fd[%d], events[%u]", fd, poll_events);
+  }
+
+  void IoUringPoller::deleteEvent(FdEvent *event)
+  {
+    int fd = event->getFd();
+    if (fd < 0 || (size_t)fd >= m_entries.size() || !m_entries[fd].m_registered)
+    {
+      return;
+    }
+    Entry &entry = m_entries[fd];
+    disarmEntry(fd, entry);
+    cancelRead(fd, entry);
+    cancelWrite(fd, entry);
+    entry = Entry();
+    DEBUGLOG("delete event success, fd[%d]", fd);
+  }
+
+  int IoUringPoller::poll(std::vector<epoll_event> &events, int timeout_ms)
+  {
+    // 水平触发的单次 poll 和读完成之后重新提交，和其他修改一起批量进入内核
+    for (size_t i = 0; i < m_rearm_fds.size(); ++i)
+    {
+      int fd = m_rearm_fds[i];
+      Entry &entry = m_entries[fd];
+      if (!entry.m_registered)
+      {
+        continue;
+      }
+      if (entry.m_async_read && !entry.m_reading && !entry.m_read_ready)
+      {
+        armRead(fd, entry);
+      }
+      if (!entry.m_armed && (entry.m_events & (EPOLLIN | EPOLLOUT)))
+      {
+        armEntry(fd, entry);
+      }
+    }
+    m_rearm_fds.clear();
+
+    bool has_ready = *m_cq_head != __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+    unsigned min_complete = 0;
+    if (!has_ready && timeout_ms != 0)
+    {
+      min_complete = 1;
+      if (timeout_ms > 0)
+      {
+        // 超时 sqe 在任意一个新完成事件到达或超时后结束
+        struct io_uring_sqe *sqe = getSqe();
+        if (sqe)
+        {
+          m_timeout_ts.tv_sec = timeout_ms / 1000;
+          m_timeout_ts.tv_nsec = (long long)(timeout_ms % 1000) * 1000000;
+          sqe->opcode = IORING_OP_TIMEOUT;
+          sqe->fd = -1;
+          sqe->addr = (uint64_t)(uintptr_t)&m_timeout_ts;
+          sqe->len = 1;
+          sqe->off = 1;
+          sqe->user_data = g_ignore_user_data;
+        }
+      }
+    }
+
+    unsigned to_submit = *m_sq_tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+    if (to_submit > 0 || min_complete > 0)
+    {
+      int rt = enter(to_submit, min_complete, min_complete > 0 ? IORING_ENTER_GETEVENTS : 0);
+      if (rt < 0 && errno != EINTR && errno != ETIME && errno != EBUSY && errno != EAGAIN)
+      {
+        return -1;
+      }
+    }
+
+    int count = 0;
+    unsigned head = *m_cq_head;
+    unsigned tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail && count < (int)events.size())
+    {
+      struct io_uring_cqe *cqe = &m_cqes[head & *m_cq_mask];
+      ++head;
+
+      if (cqe->user_data == g_ignore_user_data)
+      {
+        continue;
+      }
+      UringOp op = (UringOp)(cqe->user_data >> 62);
+      int fd = (int)((cqe->user_data >> 32) & 0x3fffffff);
+      uint32_t token = (uint32_t)cqe->user_data;
+
+      // 读写的结果留在 entry 里，回调通过 takeReadResult / takeWriteResult 取
+      if (op == UringOpRead || op == UringOpWrite)
+      {
+        FdEvent *ready_event = op == UringOpRead ? completeRead(fd, token, cqe->res) : completeWrite(fd, cqe->user_data, cqe->res);
+        if (ready_event)
+        {
+          epoll_event &ev = events[count++];
+          ev.events = op == UringOpRead ? EPOLLIN : EPOLLOUT;
+          ev.data.ptr = ready_event;
+        }
+        continue;
+      }
+
+      if ((size_t)fd >= m_entries.size())
+      {
+        continue;
+      }
+      Entry &entry = m_entries[fd];
+      if (!entry.m_registered || entry.m_token != token)
+      {
+        // 已经被删除或者修改过的 poll
+        continue;
+      }
+
+      if (!(cqe->flags & IORING_CQE_F_MORE))
+      {
+        entry.m_armed = false;
+        if (!entry.m_one_shot && cqe->res >= 0)
+        {
+          m_rearm_fds.push_back(fd);
+        }
+      }
+
+      uint32_t ready_events = (uint32_t)cqe->res;
+      if (cqe->res < 0)
+      {
+        if (!handlePollError(fd, entry, cqe->res))
+        {
+          continue;
+        }
+        // 重试不了：和 epoll 在坏 fd 上一样报告错误，回调里的 read / write 会拿到真正的错误并关闭连接
+        ready_events = (entry.m_events & (EPOLLIN | EPOLLOUT)) | EPOLLERR | EPOLLHUP;
+      }
+      else
+      {
+        entry.m_error_count = 0;
+      }
+
+      epoll_event &ev = events[count++];
+      ev.events = ready_events;
+      ev.data.ptr = entry.m_event;
+    }
+    __atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+
+    return count;
+  }
+
+}
@@ -0,0 +1,168 @@
+#ifndef ROCKET_NET_IO_URING_POLLER_H
+#define ROCKET_NET_IO_URING_POLLER_H
+
+#include <stdint.h>
+#include <unordered_map>
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include "rocket/net/poller.h"
+
+namespace rocket
+{
+
+  /// @brief 基于 io_uring 的 Poller
+  /// 每个 fd 的监听对应一个 IORING_OP_POLL_ADD，一轮 loop 里所有的注册、修改、删除和水平触发的
+  /// 重新提交都只写进 SQ，等到 poll() 时和等待合并成一次 io_uring_enter，省掉逐个 epoll_ctl 的系统调用。
+  /// 水平触发用单次 poll 在完成后重新提交实现，边缘触发用 multishot poll，ONESHOT 完成后不再提交。
+  /// multishot poll 需要 5.13 以上的内核，启动时试一次，不支持时边缘触发也用单次 poll 加重新提交。
+  /// poll 以错误完成时重新提交，连续失败或者 fd 已经无效时按 epoll 的方式报告 EPOLLERR，由回调自己发现问题并关闭
+  ///
+  /// 标记了 async io 的 fd（服务端连接）不用 poll 等可读，而是一直挂着一个 IORING_OP_READ_FIXED，
+  /// 读进启动时用 io_uring_register 注册的缓冲区，数据随完成事件回来，回调里只剩一次拷贝；
+  /// 写用 IORING_OP_WRITEV 提交，完成后以 EPOLLOUT 通知。读写都不再单独进内核，和 poll 一起批量提交。
+  /// 注册缓冲区按固定大小切成槽位，每个正在读的 fd 占一个，槽位用完时这个 fd 退回 poll 可读。
+  /// 内核对 socket 的 READ_FIXED 不等待直接返回 EAGAIN（老内核）或者不支持时，整个后端关掉异步读写
+  class IoUringPoller : public Poller
+  {
+  public:
+    IoUringPoller();
+
+    ~IoUringPoller();
+
+    // 内核不支持或者禁用了 io_uring 时返回 false
+    bool isValid();
+
+    void addEvent(FdEvent *event);
+
+    void deleteEvent(FdEvent *event);
+
+    int poll(std::vector<epoll_event> &events, int timeout_ms);
+
+    const char *name()
+    {
+      return "io_uring";
+    }
+
+    bool supportAsyncIo();
+
+    bool takeReadResult(FdEvent *event, const char *&data, int &res);
+
+    bool submitWrite(FdEvent *event, const struct iovec *vec, int count, std::shared_ptr<void> holder);
+
+    bool takeWriteResult(FdEvent *event, int &res);
+
+  private:
+    struct Entry
+    {
+      FdEvent *m_event{NULL};
+      uint32_t m_events{0};   // 提交给内核的 poll 掩码
+      uint32_t m_token{0};    // 每次提交都换一个新值，用来丢弃已经撤销的 poll 的完成事件
+      bool m_registered{false};
+      bool m_armed{false};    // 内核里有一个未完成的 poll
+      bool m_multishot{false};
+      bool m_one_shot{false};
+      int m_error_count{0};   // 连续以错误完成的次数
+
+      bool m_async_read{false}; // 可读由异步读代替 poll
+      bool m_reading{false};    // 内核里有一个未完成的读
+      bool m_read_ready{false}; // 读已经完成，结果还没有被取走
+      int m_read_slot{-1};      // 读占用的注册缓冲区槽位
+      uint32_t m_read_token{0};
+      int m_read_res{0};
+
+      bool m_writing{false};
+      bool m_write_ready{false};
+      uint32_t m_write_token{0};
+      int m_write_res{0};
+    };
+
+    // 写完成之前内核还会访问 iovec 和它指向的内存
+    struct PendingWrite
+    {
+      std::vector<struct iovec> m_vec;
+      std::shared_ptr<void> m_holder;
+    };
+
+    bool initRing();
+
+    // 用一个立刻可写的管道提交一次 multishot poll，看内核是否支持
+    bool probeMultishotPoll();
+
+    // poll 以错误完成，能重新提交时返回 false，需要通知回调时返回 true
+    bool handlePollError(int fd, Entry &entry, int res);
+
+    struct io_uring_sqe *getSqe();
+
+    int enter(unsigned to_submit, unsigned min_complete, unsigned flags);
+
+    void armEntry(int fd, Entry &entry);
+
+    void disarmEntry(int fd, Entry &entry);
+
+    uint32_t nextToken();
+
+    // 映射并注册读缓冲区，失败时不使用异步读写
+    bool initReadSlab();
+
+    // 给 fd 提交一个读，没有空闲槽位时返回 false
+    bool submitRead(int fd, Entry &entry);
+
+    // 挂一个异步读，不行时退回 poll 可读
+    void armRead(int fd, Entry &entry);
+
+    void cancelRead(int fd, Entry &entry);
+
+    void cancelWrite(int fd, Entry &entry);
+
+    void submitCancel(uint64_t user_data);
+
+    void releaseReadSlot(int slot);
+
+    // 处理读写的完成事件，需要通知回调时返回对应的 FdEvent
+    FdEvent *completeRead(int slot, uint32_t token, int res);
+
+    FdEvent *completeWrite(int fd, uint64_t user_data, int res);
+
+  private:
+    int m_ring_fd{-1};
+
+    unsigned m_sq_entries{0};
+    unsigned *m_sq_head{NULL};
+    unsigned *m_sq_tail{NULL};
+    unsigned *m_sq_mask{NULL};
+    unsigned *m_sq_array{NULL};
+    struct io_uring_sqe *m_sqes{NULL};
+
+    unsigned *m_cq_head{NULL};
+    unsigned *m_cq_tail{NULL};
+    unsigned *m_cq_mask{NULL};
+    struct io_uring_cqe *m_cqes{NULL};
+
+    void *m_sq_ring_ptr{NULL};
+    size_t m_sq_ring_size{0};
+    void *m_cq_ring_ptr{NULL};
+    size_t m_cq_ring_size{0};
+    size_t m_sqes_size{0};
+
+    uint32_t m_next_token{1};
+
+    bool m_multishot_poll{false}; // 内核支持 IORING_POLL_ADD_MULTI
+
+    std::vector<Entry> m_entries;    // 以 fd 为下标
+
+    std::vector<int> m_rearm_fds;    // 单次 poll 或者读已经完成、下一轮需要重新提交的 fd
+
+    bool m_async_io{false};          // 读缓冲区注册成功，内核支持 socket 上的 READ_FIXED
+    char *m_read_slab{NULL};
+    size_t m_read_slab_size{0};
+    std::vector<int> m_read_slot_fds; // 每个槽位正在给哪个 fd 读，-1 为空闲
+    std::vector<int> m_free_read_slots;
+
+    std::unordered_map<uint64_t, PendingWrite> m_pending_writes; // 以 user_data 为 key
+
+    struct __kernel_timespec m_timeout_ts;
+  };
+
+}
+
+#endif
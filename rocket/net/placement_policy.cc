@@ -0,0 +1,128 @@
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include "rocket/net/placement_policy.h"
+#include "rocket/common/log.h"
+
+namespace rocket
+{
+
+  static const EventLoopStats &getLoadStats(IOThread *thread)
+  {
+    return thread->getEventLoop()->getStats();
+  }
+
+  PlacementPolicy *PlacementPolicy::CreatePlacementPolicy(const std::string &type)
+  {
+    if (type == "least_conn")
+    {
+      return new LeastConnPlacement();
+    }
+    if (type == "least_pending")
+    {
+      return new LeastPendingPlacement();
+    }
+    if (type == "p2c")
+    {
+      return new PowerOfTwoPlacement();
+    }
+    if (type == "peer_hash")
+    {
+      return new PeerHashPlacement();
+    }
+    if (type != "round_robin")
+    {
+      ERRORLOG("unknown placement policy [%s], use round_robin", type.c_str());
+    }
+    return new RoundRobinPlacement();
+  }
+
+  IOThread *RoundRobinPlacement::select(const std::vector<IOThread *> &threads, NetAddr::s_ptr peer_addr)
+  {
+    return threads[m_index.fetch_add(1, std::memory_order_relaxed) % threads.size()];
+  }
+
+  IOThread *LeastConnPlacement::select(const std::vector<IOThread *> &threads, NetAddr::s_ptr peer_addr)
+  {
+    size_t n = threads.size();
+    size_t best = m_index % n;
+    int64_t best_conns = getLoadStats(threads[best]).m_connections.load(std::memory_order_relaxed);
+    for (size_t k = 1; k < n; ++k)
+    {
+      size_t i = (m_index + k) % n;
+      int64_t conns = getLoadStats(threads[i]).m_connections.load(std::memory_order_relaxed);
+      if (conns < best_conns)
+      {
+        best = i;
+        best_conns = conns;
+      }
+    }
+    m_index = best + 1;
+    return threads[best];
+  }
+
+  IOThread *LeastPendingPlacement::select(const std::vector<IOThread *> &threads, NetAddr::s_ptr peer_addr)
+  {
+    size_t n = threads.size();
+    size_t best = m_index % n;
+    int64_t best_pending = getLoadStats(threads[best]).m_pending_task_count.load(std::memory_order_relaxed);
+    int64_t best_conns = getLoadStats(threads[best]).m_connections.load(std::memory_order_relaxed);
+    for (size_t k = 1; k < n; ++k)
+    {
+      size_t i = (m_index + k) % n;
+      int64_t pending = getLoadStats(threads[i]).m_pending_task_count.load(std::memory_order_relaxed);
+      int64_t conns = getLoadStats(threads[i]).m_connections.load(std::memory_order_relaxed);
+      if (pending < best_pending || (pending == best_pending && conns < best_conns))
+      {
+        best = i;
+        best_pending = pending;
+        best_conns = conns;
+      }
+    }
+    m_index = best + 1;
+    return threads[best];
+  }
+
+  IOThread *PowerOfTwoPlacement::select(const std::vector<IOThread *> &threads, NetAddr::s_ptr peer_addr)
+  {
+    size_t n = threads.size();
+    if (n == 1)
+    {
+      return threads[0];
+    }
+
+    // xorshift32
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+    size_t a = m_seed % n;
+    size_t b = (a + 1 + (m_seed >> 16) % (n - 1)) % n;
+
+    const EventLoopStats &sa = getLoadStats(threads[a]);
+    const EventLoopStats &sb = getLoadStats(threads[b]);
+    int64_t lag_a = sa.m_loop_lag_us.load(std::memory_order_relaxed);
+    int64_t lag_b = sb.m_loop_lag_us.load(std::memory_order_relaxed);
+    if (lag_a != lag_b)
+    {
+      return lag_a < lag_b ? threads[a] : threads[b];
+    }
+    if (sa.m_connections.load(std::memory_order_relaxed) <= sb.m_connections.load(std::memory_order_relaxed))
+    {
+      return threads[a];
+    }
+    return threads[b];
+  }
+
+  IOThread *PeerHashPlacement::select(const std::vector<IOThread *> &threads, NetAddr::s_ptr peer_addr)
+  {
+    if (!peer_addr || peer_addr->getFamily() != AF_INET)
+    {
+      return m_fallback.select(threads, peer_addr);
+    }
+
+    // 只取 ip 不取端口，同一个客户端的多条连接落在同一个线程
+    const sockaddr_in *addr = reinterpret_cast<const sockaddr_in *>(peer_addr->getSockAddr());
+    uint32_t hash = ntohl(addr->sin_addr.s_addr) * 2654435761u;
+    return threads[(hash >> 16) % threads.size()];
+  }
+
+}
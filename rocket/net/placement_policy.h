@@ -0,0 +1,93 @@
+#ifndef ROCKET_NET_PLACEMENT_POLICY_H
+#define ROCKET_NET_PLACEMENT_POLICY_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include "rocket/net/io_thread.h"
+#include "rocket/net/tcp/net_addr.h"
+
+namespace rocket
+{
+
+  /// @brief 新连接放到哪个 IO 线程上的策略，负载数据取自各个 EventLoop 的 EventLoopStats
+  /// select 只在 accept 所在的线程里调用，读到的负载是其他线程写的近似值。
+  class PlacementPolicy
+  {
+  public:
+    // threads 不为空，peer_addr 可能为空
+    virtual IOThread *select(const std::vector<IOThread *> &threads, NetAddr::s_ptr peer_addr) = 0;
+
+    virtual const char *name() = 0;
+
+    virtual ~PlacementPolicy() {}
+
+  public:
+    // round_robin / least_conn / least_pending / p2c / peer_hash，未知的类型使用 round_robin
+    static PlacementPolicy *CreatePlacementPolicy(const std::string &type);
+  };
+
+  // 轮流分配
+  class RoundRobinPlacement : public PlacementPolicy
+  {
+  public:
+    IOThread *select(const std::vector<IOThread *> &threads, NetAddr::s_ptr peer_addr);
+
+    const char *name() { return "round_robin"; }
+
+  private:
+    std::atomic<size_t> m_index{0};
+  };
+
+  // 当前连接数最少的线程，连接数相同的从上次选中的下一个开始轮流
+  class LeastConnPlacement : public PlacementPolicy
+  {
+  public:
+    IOThread *select(const std::vector<IOThread *> &threads, NetAddr::s_ptr peer_addr);
+
+    const char *name() { return "least_conn"; }
+
+  private:
+    size_t m_index{0};
+  };
+
+  // 待执行任务最少的线程，任务数相同时比较连接数
+  class LeastPendingPlacement : public PlacementPolicy
+  {
+  public:
+    IOThread *select(const std::vector<IOThread *> &threads, NetAddr::s_ptr peer_addr);
+
+    const char *name() { return "least_pending"; }
+
+  private:
+    size_t m_index{0};
+  };
+
+  // 随机挑两个线程，选 loop lag 小的那个，lag 相同时比较连接数；
+  // 只读两个线程的负载，线程多时比全量扫描便宜，也不会让所有新连接同时涌向同一个最空闲的线程
+  class PowerOfTwoPlacement : public PlacementPolicy
+  {
+  public:
+    IOThread *select(const std::vector<IOThread *> &threads, NetAddr::s_ptr peer_addr);
+
+    const char *name() { return "p2c"; }
+
+  private:
+    uint32_t m_seed{2463534242u};
+  };
+
+  // 按对端 ip 哈希，同一个客户端的连接总是落在同一个线程，拿不到 ip 时退回轮流分配
+  class PeerHashPlacement : public PlacementPolicy
+  {
+  public:
+    IOThread *select(const std::vector<IOThread *> &threads, NetAddr::s_ptr peer_addr);
+
+    const char *name() { return "peer_hash"; }
+
+  private:
+    RoundRobinPlacement m_fallback;
+  };
+
+}
+
+#endif
@@ -0,0 +1,37 @@
+#include <string>
+#include "rocket/net/poller.h"
+#include "rocket/net/epoll_poller.h"
+#include "rocket/net/io_uring_poller.h"
+#include "rocket/common/config.h"
+#include "rocket/common/log.h"
+
+namespace rocket
+{
+
+  Poller *Poller::CreatePoller()
+  {
+    std::string type = "epoll";
+    if (Config::GetGlobalConfig())
+    {
+      type = Config::GetGlobalConfig()->m_poller;
+    }
+
+    if (type == "io_uring")
+    {
+      IoUringPoller *poller = new IoUringPoller();
+      if (poller->isValid())
+      {
+        return poller;
+      }
+      ERRORLOG("io_uring is not available in this kernel, fall back to epoll");
+      delete poller;
+    }
+    else if (type != "epoll")
+    {
+      ERRORLOG("unknown poller type [%s], use epoll", type.c_str());
+    }
+
+    return new EpollPoller();
+  }
+
+}
@@ -0,0 +1,65 @@
+#ifndef ROCKET_NET_POLLER_H
+#define ROCKET_NET_POLLER_H
+
+#include <vector>
+#include <memory>
+#include <sys/epoll.h>
+#include <sys/uio.h>
+#include "rocket/net/fd_event.h"
+
+namespace rocket
+{
+
+  /// @brief IO 多路复用后端的抽象，EventLoop 只通过这个接口注册 fd 和等待事件
+  /// 所有方法只允许在所属 EventLoop 的线程里调用。
+  class Poller
+  {
+  public:
+    // 注册或修改 fd 的监听事件，监听的事件和触发方式都取自 event->getEpollEvent()
+    virtual void addEvent(FdEvent *event) = 0;
+
+    // 取消 fd 的全部监听
+    virtual void deleteEvent(FdEvent *event) = 0;
+
+    // 等待就绪事件，结果按 epoll_event 的格式填入 events，data.ptr 为对应的 FdEvent
+    // 返回就绪事件的个数，出错返回 -1 并设置 errno
+    virtual int poll(std::vector<epoll_event> &events, int timeout_ms) = 0;
+
+    virtual const char *name() = 0;
+
+    // 以下是完成式读写的接口，只有 io_uring 支持，epoll 全部返回 false，调用方退回 read / writev
+    // 标记了 FdEvent::setAsyncIo 的 fd 监听可读时由后端直接提交读，读完以 EPOLLIN 通知；
+    // submitWrite 提交的写完成后以 EPOLLOUT 通知，不需要监听可写
+    virtual bool supportAsyncIo()
+    {
+      return false;
+    }
+
+    // 取出已经完成的读，data 指向后端的缓冲区，在回调返回之前有效；res 同 read 的返回值，出错时为 -errno
+    virtual bool takeReadResult(FdEvent *event, const char *&data, int &res)
+    {
+      return false;
+    }
+
+    // 提交一次写，holder 持有 iovec 指向的内存直到写完成；同一个 fd 同时只能有一个写
+    virtual bool submitWrite(FdEvent *event, const struct iovec *vec, int count, std::shared_ptr<void> holder)
+    {
+      return false;
+    }
+
+    // 取出已经完成的写，res 同 writev 的返回值，出错时为 -errno
+    virtual bool takeWriteResult(FdEvent *event, int &res)
+    {
+      return false;
+    }
+
+    virtual ~Poller() {}
+
+  public:
+    // 根据配置的 <server><poller> 创建后端，io_uring 不可用时回退到 epoll
+    static Poller *CreatePoller();
+  };
+
+}
+
+#endif
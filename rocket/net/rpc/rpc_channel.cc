@@ -91,6 +91,16 @@ namespace rocket
     }
 
     req_protocol->m_method_name = method->full_name();
+    // 第一次用到这个服务的 stub 时注册它所有方法的方法号，之后只是一次不加锁的查表
+    if (!TinyPBProtocol::IsMethodRegistered(req_protocol->m_method_name))
+    {
+      std::vector<std::string> method_names;
+      for (int i = 0; i < method->service()->method_count(); ++i)
+      {
+        method_names.push_back(method->service()->method(i)->full_name());
+      }
+      TinyPBProtocol::RegisterMethods(method_names);
+    }
     INFOLOG("%s | call method name [%s]", req_protocol->m_msg_id.c_str(), req_protocol->m_method_name.c_str());
 
     if (!m_is_init)
@@ -164,7 +174,7 @@ namespace rocket
                                                                                              rsp_protocol->m_msg_id.c_str(), rsp_protocol->m_method_name.c_str(),
                                                                                              getTcpClient()->getPeerAddr()->toString().c_str(), getTcpClient()->getLocalAddr()->toString().c_str());
 
-                                                                                     if (!(getResponse()->ParseFromString(rsp_protocol->m_pb_data)))
+                                                                                     if (!(getResponse()->ParseFromArray(rsp_protocol->pbData(), rsp_protocol->pbDataLength())))
                                                                                      {
                                                                                        ERRORLOG("%s | serialize error", rsp_protocol->m_msg_id.c_str());
                                                                                        my_controller->SetError(ERROR_FAILED_SERIALIZE, "serialize error");
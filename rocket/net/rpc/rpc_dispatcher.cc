@@ -34,6 +34,14 @@ namespace rocket
     return g_rpc_dispatcher;
   }
 
+  // 每个分发出去的请求都要回一次包，出错时回错误码，连接靠回包数判断请求是否都处理完了
+  static void replyMessage(std::shared_ptr<TinyPBProtocol> rsp_protocol, TcpConnection *connection)
+  {
+    std::vector<AbstractProtocol::s_ptr> replay_messages;
+    replay_messages.emplace_back(rsp_protocol);
+    connection->reply(replay_messages);
+  }
+
   /// @brief 这个函数帮我们根据请求找到要执行的方法名
   /// @param request 
   /// @param response 
@@ -58,6 +66,7 @@ namespace rocket
     if (!parseServiceFullName(method_full_name, service_name, method_name))
     {
       setTinyPBError(rsp_protocol, ERROR_PARSE_SERVICE_NAME, "parse service name error");
+      replyMessage(rsp_protocol, connection);
       return;
     }
 
@@ -67,6 +76,7 @@ namespace rocket
     {
       ERRORLOG("%s | sericve neame[%s] not found", req_protocol->m_msg_id.c_str(), service_name.c_str());
       setTinyPBError(rsp_protocol, ERROR_SERVICE_NOT_FOUND, "service not found");
+      replyMessage(rsp_protocol, connection);
       return;
     }
 
@@ -78,6 +88,7 @@ namespace rocket
     {
       ERRORLOG("%s | method neame[%s] not found in service[%s]", req_protocol->m_msg_id.c_str(), method_name.c_str(), service_name.c_str());
       setTinyPBError(rsp_protocol, ERROR_SERVICE_NOT_FOUND, "method not found");
+      replyMessage(rsp_protocol, connection);
       return;
     }
 
@@ -85,10 +96,11 @@ namespace rocket
     google::protobuf::Message *req_msg = service->GetRequestPrototype(method).New();
 
     // 反序列化，将 pb_data 反序列化为 req_msg
-    if (!req_msg->ParseFromString(req_protocol->m_pb_data))
+    if (!req_msg->ParseFromArray(req_protocol->pbData(), req_protocol->pbDataLength()))
     {
       ERRORLOG("%s | deserilize error", req_protocol->m_msg_id.c_str(), method_name.c_str(), service_name.c_str());
       setTinyPBError(rsp_protocol, ERROR_FAILED_DESERIALIZE, "deserilize error");
+      replyMessage(rsp_protocol, connection);
       DELETE_RESOURCE(req_msg);
       return;
     }
@@ -121,9 +133,7 @@ namespace rocket
                                              INFOLOG("%s | dispatch success, requesut[%s], response[%s]", req_protocol->m_msg_id.c_str(), req_msg->ShortDebugString().c_str(), rsp_msg->ShortDebugString().c_str());
                                            }
 
-                                           std::vector<AbstractProtocol::s_ptr> replay_messages;
-                                           replay_messages.emplace_back(rsp_protocol);
-                                           connection->reply(replay_messages);
+                                           replyMessage(rsp_protocol, connection);
                                          });
     //调用方法
     service->CallMethod(method, rpc_controller, req_msg, rsp_msg, closure);
@@ -161,6 +171,14 @@ namespace rocket
   {
     std::string service_name = service->GetDescriptor()->full_name();
     m_service_map[service_name] = service;
+
+    // 注册方法号，TinyPB v2 的请求可以只带 4 字节方法号
+    std::vector<std::string> method_names;
+    for (int i = 0; i < service->GetDescriptor()->method_count(); ++i)
+    {
+      method_names.push_back(service->GetDescriptor()->method(i)->full_name());
+    }
+    TinyPBProtocol::RegisterMethods(method_names);
   }
 
   /// @brief 设置错误信息
@@ -0,0 +1,19 @@
+#ifndef ROCKET_NET_TASK_PRIORITY_H
+#define ROCKET_NET_TASK_PRIORITY_H
+
+namespace rocket
+{
+
+  // EventLoop 任务的优先级，数值越小越先执行
+  enum TaskPriority
+  {
+    TaskPriorityIO = 0,         // IO 事件相关：注册/删除监听、非内联模式下的 IO 回调
+    TaskPriorityReply = 1,      // RPC 回包
+    TaskPriorityTimer = 2,      // 定时任务
+    TaskPriorityBackground = 3, // 后台维护：清理连接、日志同步等
+    TaskPriorityCount = 4,
+  };
+
+}
+
+#endif
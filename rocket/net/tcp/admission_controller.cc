@@ -0,0 +1,156 @@
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include "rocket/net/tcp/admission_controller.h"
+#include "rocket/net/tcp/tcp_buffer.h"
+#include "rocket/net/coder/tinypb_coder.h"
+#include "rocket/net/coder/tinypb_protocol.h"
+#include "rocket/common/error_code.h"
+#include "rocket/common/log.h"
+
+namespace rocket
+{
+
+  AdmissionController::AdmissionController(IOThreadGroup *io_thread_group, int max_connections, int max_connections_per_thread, int max_connections_per_ip, const std::string &over_limit_action)
+      : m_io_thread_group(io_thread_group), m_max_connections(max_connections), m_max_connections_per_thread(max_connections_per_thread), m_max_connections_per_ip(max_connections_per_ip)
+  {
+    if (over_limit_action == "close")
+    {
+      m_over_limit_action = OverLimitClose;
+    }
+    else if (over_limit_action == "pause")
+    {
+      m_over_limit_action = OverLimitPause;
+    }
+    else
+    {
+      if (over_limit_action != "reject")
+      {
+        ERRORLOG("unknown over_limit_action [%s], use reject", over_limit_action.c_str());
+      }
+      m_over_limit_action = OverLimitReject;
+    }
+  }
+
+  AdmissionController::~AdmissionController()
+  {
+  }
+
+  AdmissionController::OverLimitAction AdmissionController::getOverLimitAction()
+  {
+    return m_over_limit_action;
+  }
+
+  bool AdmissionController::isFull()
+  {
+    if (m_max_connections <= 0)
+    {
+      return false;
+    }
+    int total = 0;
+    for (int i = 0; i < m_io_thread_group->size(); ++i)
+    {
+      total += m_io_thread_group->getIOThreadAt(i)->getEventLoop()->getStats().m_connections.load(std::memory_order_relaxed);
+    }
+    return total >= m_max_connections;
+  }
+
+  bool AdmissionController::isThreadFull(IOThread *io_thread)
+  {
+    if (m_max_connections_per_thread <= 0)
+    {
+      return false;
+    }
+    return io_thread->getEventLoop()->getStats().m_connections.load(std::memory_order_relaxed) >= m_max_connections_per_thread;
+  }
+
+  IOThread *AdmissionController::findAvailableThread(IOThread *prefer)
+  {
+    if (prefer && !isThreadFull(prefer))
+    {
+      return prefer;
+    }
+    for (int i = 0; i < m_io_thread_group->size(); ++i)
+    {
+      IOThread *io_thread = m_io_thread_group->getIOThreadAt(i);
+      if (!isThreadFull(io_thread))
+      {
+        return io_thread;
+      }
+    }
+    return NULL;
+  }
+
+  bool AdmissionController::getPeerKey(NetAddr::s_ptr peer_addr, uint32_t &key)
+  {
+    // 只统计 ipv4 对端
+    if (!peer_addr || peer_addr->getFamily() != AF_INET)
+    {
+      return false;
+    }
+    const sockaddr_in *addr = reinterpret_cast<const sockaddr_in *>(peer_addr->getSockAddr());
+    key = addr->sin_addr.s_addr;
+    return true;
+  }
+
+  bool AdmissionController::acquirePeer(NetAddr::s_ptr peer_addr)
+  {
+    uint32_t key = 0;
+    if (m_max_connections_per_ip <= 0 || !getPeerKey(peer_addr, key))
+    {
+      return true;
+    }
+    ScopeMutex<Mutex> lock(m_mutex);
+    int &count = m_peer_connections[key];
+    if (count >= m_max_connections_per_ip)
+    {
+      return false;
+    }
+    ++count;
+    return true;
+  }
+
+  void AdmissionController::releasePeer(NetAddr::s_ptr peer_addr)
+  {
+    uint32_t key = 0;
+    if (m_max_connections_per_ip <= 0 || !getPeerKey(peer_addr, key))
+    {
+      return;
+    }
+    ScopeMutex<Mutex> lock(m_mutex);
+    auto it = m_peer_connections.find(key);
+    if (it == m_peer_connections.end())
+    {
+      return;
+    }
+    if (--it->second <= 0)
+    {
+      m_peer_connections.erase(it);
+    }
+  }
+
+  void AdmissionController::refuse(int fd, bool send_error)
+  {
+    if (send_error)
+    {
+      // 新连接的发送缓冲区是空的，一次非阻塞 write 基本都能写完，写不完就放弃
+      std::shared_ptr<TinyPBProtocol> message = std::make_shared<TinyPBProtocol>();
+      message->m_msg_id = "0";
+      message->m_err_code = ERROR_SERVER_OVERLOADED;
+      message->m_err_info = "server overloaded";
+
+      std::vector<AbstractProtocol::s_ptr> messages;
+      messages.push_back(message);
+      TcpBuffer::s_ptr buffer = std::make_shared<TcpBuffer>(128);
+      TinyPBCoder coder;
+      coder.encode(messages, buffer);
+
+      if (write(fd, buffer->readPtr(), buffer->readAble()) < 0)
+      {
+        DEBUGLOG("write overload error frame failed, fd=%d", fd);
+      }
+    }
+    close(fd);
+  }
+
+}
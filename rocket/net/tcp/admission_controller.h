@@ -0,0 +1,70 @@
+#ifndef ROCKET_NET_TCP_ADMISSION_CONTROLLER_H
+#define ROCKET_NET_TCP_ADMISSION_CONTROLLER_H
+
+#include <map>
+#include <string>
+#include <stdint.h>
+#include "rocket/common/mutex.h"
+#include "rocket/net/tcp/net_addr.h"
+#include "rocket/net/io_thread_group.h"
+
+namespace rocket
+{
+
+  /// @brief 在 accept 时做连接准入控制
+  /// 全局和单个 IO 线程的连接数直接取各个 EventLoop 统计里的连接数（放置时 +1，关闭时 -1），
+  /// 同一个对端 ip 的连接数由这里自己维护，连接关闭时调用 releasePeer 归还。
+  /// 所有上限为 0 表示不限制。
+  class AdmissionController
+  {
+  public:
+    enum OverLimitAction
+    {
+      OverLimitReject = 1, // 回一个 TinyPB 错误帧后关闭
+      OverLimitClose = 2,  // 直接关闭
+      OverLimitPause = 3,  // 暂停 accept，新连接留在内核的 backlog 里，连接数降下来后恢复
+    };
+
+  public:
+    AdmissionController(IOThreadGroup *io_thread_group, int max_connections, int max_connections_per_thread, int max_connections_per_ip, const std::string &over_limit_action);
+
+    ~AdmissionController();
+
+    OverLimitAction getOverLimitAction();
+
+    // 全局连接数达到上限
+    bool isFull();
+
+    // 这个 IO 线程的连接数达到上限
+    bool isThreadFull(IOThread *io_thread);
+
+    // 找一个连接数没到上限的 IO 线程，prefer 没满时直接返回 prefer，全都满了返回 NULL
+    IOThread *findAvailableThread(IOThread *prefer);
+
+    // 对端 ip 的连接数 +1，已经到上限时返回 false 且不计数
+    bool acquirePeer(NetAddr::s_ptr peer_addr);
+
+    void releasePeer(NetAddr::s_ptr peer_addr);
+
+    // 超限的连接：reject 时先尽量写一个带 ERROR_SERVER_OVERLOADED 的错误帧，然后关闭 fd
+    void refuse(int fd, bool send_error);
+
+  private:
+    bool getPeerKey(NetAddr::s_ptr peer_addr, uint32_t &key);
+
+  private:
+    IOThreadGroup *m_io_thread_group{NULL};
+
+    int m_max_connections{0};
+    int m_max_connections_per_thread{0};
+    int m_max_connections_per_ip{0};
+
+    OverLimitAction m_over_limit_action{OverLimitReject};
+
+    Mutex m_mutex;
+    std::map<uint32_t, int> m_peer_connections; // ipv4 地址 -> 连接数
+  };
+
+}
+
+#endif
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include "rocket/net/tcp/idle_connection_manager.h"
+#include "rocket/common/clock.h"
+#include "rocket/common/log.h"
+
+namespace rocket
+{
+
+  // 每个周期至少分成多少个 tick，决定超时判断的精度
+  static const int64_t g_ticks_per_period = 8;
+
+  static const int64_t g_min_tick_us = 10 * 1000;
+
+  IdleConnectionManager::IdleConnectionManager(EventLoop *event_loop, int idle_timeout_ms, int heartbeat_interval_ms)
+      : m_event_loop(event_loop), m_idle_timeout_us((int64_t)idle_timeout_ms * 1000), m_heartbeat_interval_us((int64_t)heartbeat_interval_ms * 1000)
+  {
+    int64_t min_period = 0;
+    int64_t max_period = std::max(m_idle_timeout_us, m_heartbeat_interval_us);
+    if (m_idle_timeout_us > 0 && m_heartbeat_interval_us > 0)
+    {
+      min_period = std::min(m_idle_timeout_us, m_heartbeat_interval_us);
+    }
+    else
+    {
+      min_period = max_period;
+    }
+    if (max_period <= 0)
+    {
+      return;
+    }
+
+    m_tick_us = std::max(min_period / g_ticks_per_period, g_min_tick_us);
+    m_buckets.resize(max_period / m_tick_us + 2);
+
+    m_timer_event = TimerEvent::CreateByUs(m_tick_us, true, std::bind(&IdleConnectionManager::onTick, this));
+    m_timer_event->setPriority(TaskPriorityBackground);
+    m_event_loop->addTimerEvent(m_timer_event);
+  }
+
+  IdleConnectionManager::~IdleConnectionManager()
+  {
+    if (m_timer_event)
+    {
+      m_timer_event->setCancled(true);
+      m_event_loop->deleteTimerEvent(m_timer_event);
+    }
+  }
+
+  void IdleConnectionManager::add(TcpConnection::s_ptr connection)
+  {
+    if (m_buckets.empty())
+    {
+      return;
+    }
+    int64_t now = Clock::CachedUs();
+    int64_t deadline = now + (m_heartbeat_interval_us > 0 ? m_heartbeat_interval_us : m_idle_timeout_us);
+    if (m_idle_timeout_us > 0)
+    {
+      deadline = std::min(deadline, now + m_idle_timeout_us);
+    }
+    place(connection, now, deadline);
+  }
+
+  void IdleConnectionManager::place(TcpConnection::s_ptr connection, int64_t now, int64_t deadline)
+  {
+    // 第 k 个 tick 之后检查的桶是 m_cursor + k - 1，超时最多晚一个 tick 被发现
+    int64_t k = (deadline - now + m_tick_us - 1) / m_tick_us;
+    k = std::max((int64_t)1, std::min(k, (int64_t)m_buckets.size()));
+    m_buckets[(m_cursor + k - 1) % m_buckets.size()].push_back(connection);
+  }
+
+  void IdleConnectionManager::onTick()
+  {
+    std::vector<std::weak_ptr<TcpConnection>> bucket;
+    bucket.swap(m_buckets[m_cursor]);
+    m_cursor = (m_cursor + 1) % m_buckets.size();
+
+    int64_t now = Clock::CachedUs();
+    for (size_t i = 0; i < bucket.size(); ++i)
+    {
+      TcpConnection::s_ptr connection = bucket[i].lock();
+      if (!connection || connection->getState() != Connected)
+      {
+        continue;
+      }
+
+      int64_t last_read = connection->getLastReadUs();
+      int64_t last_active = std::max(last_read, connection->getLastWriteUs());
+      if (m_idle_timeout_us > 0 && now - last_active >= m_idle_timeout_us)
+      {
+        INFOLOG("close idle connection, peer addr[%s], fd[%d], idle %lld ms", connection->getPeerAddr()->toString().c_str(),
+                connection->getFd(), (long long)(now - last_active) / 1000);
+        connection->clear();
+        continue;
+      }
+
+      int64_t deadline = 0;
+      if (m_idle_timeout_us > 0)
+      {
+        deadline = last_active + m_idle_timeout_us;
+      }
+      if (m_heartbeat_interval_us > 0)
+      {
+        // 对端一个心跳周期没有发来任何数据，并且这个周期里还没发过 ping
+        int64_t last_ping = connection->getLastHeartbeatUs();
+        if (now - last_read >= m_heartbeat_interval_us && now - last_ping >= m_heartbeat_interval_us)
+        {
+          connection->sendHeartbeat();
+          last_ping = now;
+        }
+        int64_t next_ping = std::max(last_read, last_ping) + m_heartbeat_interval_us;
+        deadline = deadline > 0 ? std::min(deadline, next_ping) : next_ping;
+      }
+      place(connection, now, deadline);
+    }
+  }
+
+}
@@ -0,0 +1,51 @@
+#ifndef ROCKET_NET_TCP_IDLE_CONNECTION_MANAGER_H
+#define ROCKET_NET_TCP_IDLE_CONNECTION_MANAGER_H
+
+#include <vector>
+#include <memory>
+#include "rocket/net/eventloop.h"
+#include "rocket/net/timer_event.h"
+#include "rocket/net/tcp/tcp_connection.h"
+
+namespace rocket
+{
+
+  /// @brief 一个 IO 线程上的空闲连接检测，整个 loop 只有一个重复的 TimerEvent
+  /// 连接按下一次需要检查的时间放进环形的桶里，每个 tick 只检查到期的那个桶。
+  /// 读写时连接只更新自己的时间戳，不在桶之间移动；检查时发现还没到期就按最新的时间重新放桶。
+  /// - 读写都空闲超过 idle_timeout 的连接直接关闭
+  /// - 读空闲超过 heartbeat_interval 的连接发送心跳 ping，正常的对端回 pong 就算一次读
+  /// 只允许在所属 EventLoop 的线程里调用 add。
+  class IdleConnectionManager
+  {
+  public:
+    // 两个时间都是 ms，0 表示关闭对应的功能
+    IdleConnectionManager(EventLoop *event_loop, int idle_timeout_ms, int heartbeat_interval_ms);
+
+    ~IdleConnectionManager();
+
+    void add(TcpConnection::s_ptr connection);
+
+  private:
+    void onTick();
+
+    // 把连接放到 deadline 之前最后一个会被检查的桶里
+    void place(TcpConnection::s_ptr connection, int64_t now, int64_t deadline);
+
+  private:
+    EventLoop *m_event_loop{NULL};
+
+    int64_t m_idle_timeout_us{0};
+    int64_t m_heartbeat_interval_us{0};
+
+    int64_t m_tick_us{0};
+
+    std::vector<std::vector<std::weak_ptr<TcpConnection>>> m_buckets;
+    size_t m_cursor{0}; // 下一个 tick 检查的桶
+
+    TimerEvent::s_ptr m_timer_event;
+  };
+
+}
+
+#endif
@@ -2,15 +2,21 @@
 #include <sys/socket.h>
 #include <fcntl.h>
 #include <string.h>
+#include <errno.h>
+#include <linux/filter.h>
 #include "rocket/common/log.h"
 #include "rocket/net/tcp/net_addr.h"
 #include "rocket/net/tcp/tcp_acceptor.h"
 
+#ifndef SO_ATTACH_REUSEPORT_CBPF
+#define SO_ATTACH_REUSEPORT_CBPF 51
+#endif
+
 namespace rocket
 {
   /* 封装socket->bind->listen->accept的一个过程*/
 
-  TcpAcceptor::TcpAcceptor(NetAddr::s_ptr local_addr) : m_local_addr(local_addr)
+  TcpAcceptor::TcpAcceptor(NetAddr::s_ptr local_addr, bool reuse_port /*= false*/, int backlog /*= 1000*/) : m_local_addr(local_addr)
   {
     if (!local_addr->checkValid())
     {
@@ -21,7 +27,7 @@ namespace rocket
     m_family = m_local_addr->getFamily();
 
     //1.生成监听套接字
-    m_listenfd = socket(m_family, SOCK_STREAM, 0);
+    m_listenfd = socket(m_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
 
     if (m_listenfd < 0)
     {
@@ -36,6 +42,12 @@ namespace rocket
       ERRORLOG("setsockopt REUSEADDR error, errno=%d, error=%s", errno, strerror(errno));
     }
 
+    if (reuse_port && setsockopt(m_listenfd, SOL_SOCKET, SO_REUSEPORT, &val, sizeof(val)) != 0)
+    {
+      ERRORLOG("setsockopt REUSEPORT error, errno=%d, error=%s", errno, strerror(errno));
+      exit(0);
+    }
+
     //3.bind,绑定本地IP和端口
     socklen_t len = m_local_addr->getSockLen();
     if (bind(m_listenfd, m_local_addr->getSockAddr(), len) != 0)
@@ -45,7 +57,7 @@ namespace rocket
     }
 
     //4.listen设置监听
-    if (listen(m_listenfd, 1000) != 0)
+    if (listen(m_listenfd, backlog) != 0)
     {
       ERRORLOG("listen error, errno=%d, error=%s", errno, strerror(errno));
       exit(0);
@@ -63,7 +75,32 @@ namespace rocket
     return m_listenfd;
   }
 
-  //5.accept等待客户端连接
+  bool TcpAcceptor::attachCpuSteeringFilter(int group_size)
+  {
+    if (group_size <= 0)
+    {
+      return false;
+    }
+
+    // A = 当前 cpu; A = A % group_size; return A
+    sock_filter code[] = {
+        {BPF_LD | BPF_W | BPF_ABS, 0, 0, (uint32_t)(SKF_AD_OFF + SKF_AD_CPU)},
+        {BPF_ALU | BPF_MOD | BPF_K, 0, 0, (uint32_t)group_size},
+        {BPF_RET | BPF_A, 0, 0, 0},
+    };
+    sock_fprog prog;
+    prog.len = sizeof(code) / sizeof(code[0]);
+    prog.filter = code;
+
+    if (setsockopt(m_listenfd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) != 0)
+    {
+      ERRORLOG("setsockopt ATTACH_REUSEPORT_CBPF error, errno=%d, error=%s", errno, strerror(errno));
+      return false;
+    }
+    return true;
+  }
+
+  //5.accept 取一个新连接，没有新连接时返回 -1
   std::pair<int, NetAddr::s_ptr> TcpAcceptor::accept()
   {
     if (m_family == AF_INET)
@@ -72,10 +109,16 @@ namespace rocket
       memset(&client_addr, 0, sizeof(client_addr));
       socklen_t clien_addr_len = sizeof(client_addr);
 
-      int client_fd = ::accept(m_listenfd, reinterpret_cast<sockaddr *>(&client_addr), &clien_addr_len);
+      // 新连接直接设成非阻塞和 close-on-exec，省掉两次 fcntl
+      int client_fd = ::accept4(m_listenfd, reinterpret_cast<sockaddr *>(&client_addr), &clien_addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
       if (client_fd < 0)
       {
-        ERRORLOG("accept error, errno=%d, error=%s", errno, strerror(errno));
+        // 监听 fd 是非阻塞的，EAGAIN 表示这一轮已经取完
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNABORTED)
+        {
+          ERRORLOG("accept error, errno=%d, error=%s", errno, strerror(errno));
+        }
+        return std::make_pair(-1, nullptr);
       }
       //获取对端IP和port信息
       IPNetAddr::s_ptr peer_addr = std::make_shared<IPNetAddr>(client_addr);
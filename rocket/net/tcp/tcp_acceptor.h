@@ -12,7 +12,9 @@ namespace rocket
   public:
     typedef std::shared_ptr<TcpAcceptor> s_ptr;
 
-    TcpAcceptor(NetAddr::s_ptr local_addr);
+    // reuse_port 为 true 时设置 SO_REUSEPORT，多个 acceptor 可以监听同一个端口，由内核在它们之间分配新连接
+    // backlog 为 listen 的全连接队列长度，实际还受 net.core.somaxconn 限制
+    TcpAcceptor(NetAddr::s_ptr local_addr, bool reuse_port = false, int backlog = 1000);
 
     ~TcpAcceptor();
 
@@ -20,6 +22,10 @@ namespace rocket
 
     int getListenFd();
 
+    // 给 SO_REUSEPORT 组挂一个 CBPF 程序，按处理这个连接的软中断所在 cpu 选组内第 (cpu % group_size) 个 socket，
+    // 组内顺序就是 bind 的顺序。挂在组内任意一个 socket 上对整个组生效
+    bool attachCpuSteeringFilter(int group_size);
+
   private:
     NetAddr::s_ptr m_local_addr; // 服务端监听的地址，addr -> ip:port
 
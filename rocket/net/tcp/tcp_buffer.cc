@@ -1,18 +1,34 @@
 #include <memory>
+#include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <sys/uio.h>
+#include <sys/ioctl.h>
 #include "rocket/common/log.h"
 #include "rocket/net/tcp/tcp_buffer.h"
 
 namespace rocket
 {
 
+  // readv 的第二段，每个 IO 线程一块，读完立刻拷进连接自己的缓冲区
+  static thread_local char t_read_overflow[TcpBuffer::READ_OVERFLOW_SIZE];
+
   TcpBuffer::TcpBuffer(int size) : m_size(size)
   {
-    m_buffer.resize(size);
+    if (m_size <= 0)
+    {
+      m_size = 128;
+    }
+    reallocBuffer(m_size);
   }
 
   TcpBuffer::~TcpBuffer()
   {
+    if (m_data)
+    {
+      free(m_data);
+      m_data = NULL;
+    }
   }
 
   // 返回可读字节数
@@ -24,41 +40,83 @@ namespace rocket
   // 返回可写的字节数
   int TcpBuffer::writeAble()
   {
-    return m_buffer.size() - m_write_index;
+    return m_capacity - m_write_index;
   }
 
   /// @brief 返回读指针所在的位置
-  /// @return 
+  /// @return
   int TcpBuffer::readIndex()
   {
     return m_read_index;
   }
 
   /// @brief 返回写指针所在的位置
-  /// @return 
+  /// @return
   int TcpBuffer::writeIndex()
   {
     return m_write_index;
   }
 
+  int TcpBuffer::capacity()
+  {
+    return m_capacity;
+  }
+
+  char *TcpBuffer::data()
+  {
+    return m_data;
+  }
+
+  char *TcpBuffer::readPtr()
+  {
+    return m_data + m_read_index;
+  }
+
+  char *TcpBuffer::writePtr()
+  {
+    return m_data + m_write_index;
+  }
+
+  /// @brief 保证至少有 size 字节的可写空间
+  /// @param size
+  void TcpBuffer::ensureWriteAble(int size)
+  {
+    if (size <= writeAble())
+    {
+      return;
+    }
+    // 读过的空间加上尾部空间够用，并且挪动的数据不多于腾出来的空间，就原地挪动
+    if (m_capacity - readAble() >= size && readAble() <= m_read_index)
+    {
+      adjustBuffer();
+      return;
+    }
+    // 扩容，至少翻倍，避免连续小块写入反复扩容
+    int new_capacity = m_capacity * 2;
+    if (new_capacity < readAble() + size)
+    {
+      new_capacity = readAble() + size;
+    }
+    reallocBuffer(new_capacity);
+  }
+
   /// @brief 往buffer写入size大小的内容
-  /// @param buf 
-  /// @param size 
+  /// @param buf
+  /// @param size
   void TcpBuffer::writeToBuffer(const char *buf, int size)
   {
-    if (size > writeAble())
+    if (size <= 0)
     {
-      // 调整 buffer 的大小，扩容
-      int new_size = (int)(1.5 * (m_write_index + size));
-      resizeBuffer(new_size);
+      return;
     }
-    memcpy(&m_buffer[m_write_index], buf, size);
+    ensureWriteAble(size);
+    memcpy(m_data + m_write_index, buf, size);
     m_write_index += size;
   }
 
   /// @brief 从buffer当中读取size大小字节的内容
-  /// @param re 
-  /// @param size 
+  /// @param re
+  /// @param size
   void TcpBuffer::readFromBuffer(std::vector<char> &re, int size)
   {
     if (readAble() == 0)
@@ -68,74 +126,148 @@ namespace rocket
 
     int read_size = readAble() > size ? size : readAble();
 
-    std::vector<char> tmp(read_size);
-    memcpy(&tmp[0], &m_buffer[m_read_index], read_size);
-
-    re.swap(tmp);
-    m_read_index += read_size;
-
-    //每次读完之后就看看要不要让数组左移回收内存
-    adjustBuffer();
+    re.assign(m_data + m_read_index, m_data + m_read_index + read_size);
+    moveReadIndex(read_size);
   }
 
-  /// @brief 根据size大小扩容
-  /// @param new_size 
+  /// @brief 根据size大小扩容，可读数据超过 new_size 时只保留前 new_size 字节
+  /// @param new_size
   void TcpBuffer::resizeBuffer(int new_size)
   {
-    std::vector<char> tmp(new_size);
-    int count = std::min(new_size, readAble());
-
-    memcpy(&tmp[0], &m_buffer[m_read_index], count);
-    m_buffer.swap(tmp);
-
-    m_read_index = 0;
-    m_write_index = m_read_index + count;
+    if (new_size <= 0)
+    {
+      return;
+    }
+    if (readAble() > new_size)
+    {
+      m_write_index = m_read_index + new_size;
+    }
+    reallocBuffer(new_size);
   }
 
-  /// @brief 数组左移，回收内存
+  /// @brief 数组左移，读过的空间留给后面的写入
   void TcpBuffer::adjustBuffer()
   {
-    if (m_read_index < int(m_buffer.size() / 3))
+    if (m_read_index == 0)
     {
       return;
     }
-    std::vector<char> buffer(m_buffer.size());
     int count = readAble();
-
-    memcpy(&buffer[0], &m_buffer[m_read_index], count);
-    m_buffer.swap(buffer);
+    if (count > 0)
+    {
+      memmove(m_data, m_data + m_read_index, count);
+    }
     m_read_index = 0;
-    m_write_index = m_read_index + count;
-
-    buffer.clear();
+    m_write_index = count;
   }
 
-  /// @brief 移动读指针
-  /// @param size 
+  /// @brief 移动读指针，数据不会移动，读空时读写指针归零
+  /// @param size
   void TcpBuffer::moveReadIndex(int size)
   {
-    size_t j = m_read_index + size;
-    if (j >= m_buffer.size())
+    int j = m_read_index + size;
+    if (size < 0 || j > m_write_index)
     {
-      ERRORLOG("moveReadIndex error, invalid size %d, old_read_index %d, buffer size %d", size, m_read_index, m_buffer.size());
+      ERRORLOG("moveReadIndex error, invalid size %d, old_read_index %d, buffer size %d", size, m_read_index, m_capacity);
       return;
     }
     m_read_index = j;
-    adjustBuffer();
+    if (m_read_index == m_write_index)
+    {
+      m_read_index = 0;
+      m_write_index = 0;
+    }
   }
 
   /// @brief 移动写指针
-  /// @param size 
+  /// @param size
   void TcpBuffer::moveWriteIndex(int size)
   {
-    size_t j = m_write_index + size;
-    if (j >= m_buffer.size())
+    int j = m_write_index + size;
+    if (size < 0 || j > m_capacity)
     {
-      ERRORLOG("moveWriteIndex error, invalid size %d, old_read_index %d, buffer size %d", size, m_read_index, m_buffer.size());
+      ERRORLOG("moveWriteIndex error, invalid size %d, old_read_index %d, buffer size %d", size, m_read_index, m_capacity);
       return;
     }
     m_write_index = j;
-    adjustBuffer();
   }
 
-}
\ No newline at end of file
+  int TcpBuffer::readFromFd(int fd, bool &is_full)
+  {
+    is_full = false;
+
+    int write_able = writeAble();
+    struct iovec vec[2];
+    vec[0].iov_base = m_data + m_write_index;
+    vec[0].iov_len = write_able;
+    vec[1].iov_base = t_read_overflow;
+    vec[1].iov_len = sizeof(t_read_overflow);
+    // 尾部空间已经不小于溢出块时不需要第二段
+    int iovcnt = write_able < (int)sizeof(t_read_overflow) ? 2 : 1;
+    int max_size = write_able + (iovcnt == 2 ? (int)sizeof(t_read_overflow) : 0);
+
+    int rt = readv(fd, write_able > 0 ? vec : vec + 1, write_able > 0 ? iovcnt : 1);
+    if (rt <= 0)
+    {
+      return rt;
+    }
+
+    if (rt <= write_able)
+    {
+      m_write_index += rt;
+    }
+    else
+    {
+      m_write_index = m_capacity;
+      writeToBuffer(t_read_overflow, rt - write_able);
+    }
+
+    if (rt == max_size)
+    {
+      is_full = true;
+      // 大包：按内核接收缓冲区里剩下的字节数一次扩容，而不是每次翻倍再读一轮
+      int pending = 0;
+      if (ioctl(fd, FIONREAD, &pending) == 0 && pending > writeAble())
+      {
+        ensureWriteAble(pending);
+      }
+    }
+    return rt;
+  }
+
+  bool TcpBuffer::shrinkIfIdle()
+  {
+    if (readAble() != 0 || m_capacity <= IDLE_SHRINK_THRESHOLD || m_capacity <= m_size)
+    {
+      return false;
+    }
+    reallocBuffer(m_size);
+    return true;
+  }
+
+  /// @brief 换一块 new_capacity 大小的内存，只拷贝可读数据，拷到开头
+  /// @param new_capacity
+  void TcpBuffer::reallocBuffer(int new_capacity)
+  {
+    char *data = reinterpret_cast<char *>(malloc(new_capacity));
+    if (data == NULL)
+    {
+      ERRORLOG("malloc tcp buffer error, size %d", new_capacity);
+      exit(0);
+    }
+    int count = readAble();
+    if (count > 0)
+    {
+      memcpy(data, m_data + m_read_index, count);
+    }
+    if (m_data)
+    {
+      free(m_data);
+    }
+    m_data = data;
+    m_capacity = new_capacity;
+    m_read_index = 0;
+    m_write_index = count;
+  }
+
+}
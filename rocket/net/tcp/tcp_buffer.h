@@ -7,6 +7,9 @@
 namespace rocket
 {
 
+  /// @brief 连接的读写缓冲区，[readIndex, writeIndex) 是可读数据
+  /// 读指针移动时数据原地不动，只有写入空间不够时才把可读数据挪到开头；还不够再扩容，
+  /// 扩容只拷贝可读部分，新空间不做初始化。数据读空后读写指针直接归零。
   class TcpBuffer
   {
 
@@ -17,6 +20,10 @@ namespace rocket
 
     ~TcpBuffer();
 
+    TcpBuffer(const TcpBuffer &) = delete;
+
+    TcpBuffer &operator=(const TcpBuffer &) = delete;
+
     // 返回可读字节数
     int readAble();
 
@@ -27,27 +34,59 @@ namespace rocket
 
     int writeIndex();
 
+    int capacity();
+
+    // 缓冲区起始地址，readIndex / writeIndex 都相对于它；写入或扩容之后失效
+    char *data();
+
+    // 可读数据的起始地址
+    char *readPtr();
+
+    // 可写空间的起始地址
+    char *writePtr();
+
+    // 保证至少有 size 字节的可写空间，优先原地挪动，不够时再扩容
+    void ensureWriteAble(int size);
+
     void writeToBuffer(const char *buf, int size);
 
     void readFromBuffer(std::vector<char> &re, int size);
 
     void resizeBuffer(int new_size);
 
+    // 把可读数据挪到缓冲区开头
     void adjustBuffer();
 
     void moveReadIndex(int size);
 
     void moveWriteIndex(int size);
 
+    // 用 readv 从 fd 读一次：先填尾部空闲空间，放不下的读进线程局部的 64 KiB 溢出块再追加进来，
+    // 溢出块也读满时用 FIONREAD 按内核里剩下的字节数一次扩好容量，让下一次读能把 socket 读空。
+    // 返回值和 errno 同 read，is_full 表示这次给出的空间全部读满，socket 里可能还有数据
+    int readFromFd(int fd, bool &is_full);
+
+    // 缓冲区为空并且容量超过阈值时缩回初始大小，返回是否缩容。
+    // 由连接在一批数据处理完之后调用，偶发的大包不会让空闲连接一直占着大块内存
+    bool shrinkIfIdle();
+
+  public:
+    static const int IDLE_SHRINK_THRESHOLD = 64 * 1024;
+
+    static const int READ_OVERFLOW_SIZE = 64 * 1024;
+
+  private:
+    void reallocBuffer(int new_capacity);
+
   private:
     int m_read_index{0};
     int m_write_index{0};
-    int m_size{0};
+    int m_size{0}; // 初始容量
 
-  public:
-    std::vector<char> m_buffer;
+    char *m_data{NULL};
+    int m_capacity{0};
   };
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -28,6 +28,9 @@ namespace rocket
     m_fd_event = FdEventGroup::GetFdEventGroup()->getFdEvent(m_fd);
     //设置非阻塞
     m_fd_event->setNonBlock();
+    // fd_event 按 fd 复用，清掉之前连接可能留下的触发方式，客户端固定用水平触发
+    m_fd_event->setEdgeTriggered(false);
+    m_fd_event->setOneShot(false);
     //获取tcp connection对象
     m_connection = std::make_shared<TcpConnection>(m_event_loop, m_fd, 128, peer_addr, nullptr, TcpConnectionByClient);
     //设置tcp connection连接属性为client端发起的连接
@@ -62,6 +65,8 @@ namespace rocket
       DEBUGLOG("connect [%s] sussess", m_peer_addr->toString().c_str());
       m_connection->setState(Connected);
       initLocalAddr();
+      // 连上就监听可读，空闲时也能收到服务端的心跳 ping 并回 pong
+      m_connection->listenRead();
       //回调函数不为空，直接执行回调函数
       if (done)
       {
@@ -110,6 +115,12 @@ namespace rocket
 
                              // 连接完后需要去掉可写事件的监听，不然会一直触发
                              m_event_loop->deleteEpollEvent(m_fd_event);
+                             if (m_connection->getState() == Connected)
+                             {
+                               // 连上就监听可读，空闲时也能收到服务端的心跳 ping 并回 pong
+                               m_fd_event->cancle(FdEvent::OUT_EVENT);
+                               m_connection->listenRead();
+                             }
                              DEBUGLOG("now begin to done");
                              // 如果连接完成，才会执行回调函数
                              if (done)
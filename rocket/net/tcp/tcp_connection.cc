@@ -1,6 +1,10 @@
 #include <unistd.h>
+#include <string.h>
+#include <errno.h>
 #include "rocket/common/log.h"
+#include "rocket/common/clock.h"
 #include "rocket/net/fd_event_group.h"
+#include "rocket/net/poller.h"
 #include "rocket/net/tcp/tcp_connection.h"
 #include "rocket/net/coder/string_coder.h"
 #include "rocket/net/coder/tinypb_coder.h"
@@ -13,28 +17,52 @@ namespace rocket
   {
 
     m_in_buffer = std::make_shared<TcpBuffer>(buffer_size);
-    m_out_buffer = std::make_shared<TcpBuffer>(buffer_size);
+    m_out_queue = std::make_shared<TcpOutputQueue>();
 
     m_fd_event = FdEventGroup::GetFdEventGroup()->getFdEvent(fd);
-    //设置非阻塞
-    m_fd_event->setNonBlock();
+    //设置非阻塞，服务端的 fd 由 accept4 直接创建为非阻塞的
+    if (m_connection_type == TcpConnectionByClient)
+    {
+      m_fd_event->setNonBlock();
+    }
+    // 服务端连接的读写交给 Poller 以完成事件的方式执行（目前只有 io_uring 支持），写完成的通知走 onWrite
+    m_fd_event->setAsyncIo(m_connection_type == TcpConnectionByServer);
 
     m_coder = new TinyPBCoder();
 
+    m_last_read_us = Clock::CachedUs();
+    m_last_write_us = m_last_read_us;
+
     if (m_connection_type == TcpConnectionByServer)
     {
+      m_fd_event->listen(FdEvent::OUT_EVENT, std::bind(&TcpConnection::onWrite, this));
+      m_fd_event->cancle(FdEvent::OUT_EVENT);
       listenRead();
+      // TcpServer 选 IO 线程时已经计入了这个 loop 的连接数，这里只负责关闭时减掉
+      m_is_counted = true;
     }
   }
 
   TcpConnection::~TcpConnection()
   {
     DEBUGLOG("~TcpConnection");
+    if (m_is_counted)
+    {
+      m_event_loop->updateConnectionCount(-1);
+      m_is_counted = false;
+    }
     if (m_coder)
     {
       delete m_coder;
       m_coder = NULL;
     }
+
+    // 服务端的 fd 在最后一个引用释放时才关闭，之前 fd 号不会被新连接复用
+    if (m_connection_type == TcpConnectionByServer && m_fd >= 0)
+    {
+      close(m_fd);
+      m_fd = -1;
+    }
   }
 
   /// @brief 可读事件触发的回调函数，用于读取客户端发来的数据，组装成RPC请求
@@ -51,32 +79,45 @@ namespace rocket
       return;
     }
 
+    // 边缘触发时这次通知之后不会再有新的通知，必须一直读到 EAGAIN
+    bool is_edge_triggered = m_fd_event->isEdgeTriggered();
     bool is_read_all = false;
     bool is_close = false;
-    //读取读缓冲区的数据到in_buffer当中
-    while (!is_read_all)
+
+    // Poller 已经把数据读进了它的缓冲区，拷进 in_buffer 即可；没有结果时（epoll，或者这次退回了 poll）自己读
+    const char *async_data = NULL;
+    int async_rt = 0;
+    if (m_fd_event->isAsyncIo() && m_event_loop->getPoller()->takeReadResult(m_fd_event, async_data, async_rt))
     {
-      //buffer满了，扩容
-      if (m_in_buffer->writeAble() == 0)
+      if (async_rt > 0)
       {
-        m_in_buffer->resizeBuffer(2 * m_in_buffer->m_buffer.size());
+        m_in_buffer->writeToBuffer(async_data, async_rt);
+        m_last_read_us = Clock::CachedUs();
+        is_read_all = true;
       }
+      else
+      {
+        if (async_rt < 0)
+        {
+          ERRORLOG("read error, errno=%d, error=%s, clientfd[%d]", -async_rt, strerror(-async_rt), m_fd);
+        }
+        is_close = true;
+      }
+    }
 
-      //in_buffer当中能读多少就从缓冲区读多少
-      int read_count = m_in_buffer->writeAble();
-      int write_index = m_in_buffer->writeIndex();
-
-      int rt = read(m_fd, &(m_in_buffer->m_buffer[write_index]), read_count);
+    //读取读缓冲区的数据到in_buffer当中
+    while (!is_read_all && !is_close)
+    {
+      //一次 readv 读进 in_buffer 的尾部空间和线程局部的溢出块，in_buffer 按实际读到的大小扩容
+      bool is_full = false;
+      int rt = m_in_buffer->readFromFd(m_fd, is_full);
       DEBUGLOG("success read %d bytes from addr[%s], client fd[%d]", rt, m_peer_addr->toString().c_str(), m_fd);
       //rt表示读取的字节数
       if (rt > 0)
       {
-        m_in_buffer->moveWriteIndex(rt);
-        if (rt == read_count)
-        {
-          continue;
-        }
-        else if (rt < read_count)
+        m_last_read_us = Clock::CachedUs();
+        // 水平触发下读不满说明内核缓冲区已经空了，省掉一次返回 EAGAIN 的 read
+        if (!is_full && !is_edge_triggered)
         {
           is_read_all = true;
           break;
@@ -94,6 +135,16 @@ namespace rocket
         is_read_all = true;
         break;
       }
+      else if (rt == -1 && errno == EINTR)
+      {
+        continue;
+      }
+      else
+      {
+        ERRORLOG("read error, errno=%d, error=%s, clientfd[%d]", errno, strerror(errno), m_fd);
+        is_close = true;
+        break;
+      }
     }
      // 如果对端已经关闭，就清除
     if (is_close)
@@ -110,7 +161,14 @@ namespace rocket
     }
 
     // TODO: 简单的 echo, 后面补充 RPC 协议解析
+    m_is_reading = true;
     excute();
+    m_is_reading = false;
+
+    // 完整的包都已经处理完，偶发的大包把缓冲区撑大之后缩回去
+    m_in_buffer->shrinkIfIdle();
+
+    rearm();
   }
 
 
@@ -126,6 +184,10 @@ namespace rocket
       m_coder->decode(result, m_in_buffer);
       for (size_t i = 0; i < result.size(); ++i)
       {
+        if (handleHeartbeat(result[i]))
+        {
+          continue;
+        }
         // 1. 针对每一个请求，调用 rpc 方法，获取响应 message
         // 2. 将响应 message 放入到发送缓冲区，监听可写事件回包
         INFOLOG("success get request[%s] from client[%s]", result[i]->m_msg_id.c_str(), m_peer_addr->toString().c_str());
@@ -134,8 +196,24 @@ namespace rocket
         // message->m_pb_data = "hello. this is rocket rpc test data";
         // message->m_msg_id = result[i]->m_msg_id;
 
+        // 每个请求都会有一次 reply，可能在这里同步回，也可能交给别的线程之后再回
+        ++m_pending_replies;
         RpcDispatcher::GetRpcDispatcher()->dispatch(result[i], message, this);
       }
+
+      // 请求的 pb_data 还指向 in_buffer，下次读数据就会被覆盖；
+      // 异步处理的请求还被别处引用着，只有这些才拷贝一份
+      for (size_t i = 0; i < result.size(); ++i)
+      {
+        if (result[i].use_count() > 1)
+        {
+          std::shared_ptr<TinyPBProtocol> request = std::dynamic_pointer_cast<TinyPBProtocol>(result[i]);
+          if (request)
+          {
+            request->detach();
+          }
+        }
+      }
     }
     else
     {
@@ -145,10 +223,20 @@ namespace rocket
 
       for (size_t i = 0; i < result.size(); ++i)
       {
+        if (handleHeartbeat(result[i]))
+        {
+          continue;
+        }
         std::string msg_id = result[i]->m_msg_id;
         auto it = m_read_dones.find(msg_id);
         if (it != m_read_dones.end())
         {
+          // 回调是用户代码，可能直接读 m_pb_data 或者把消息留下来
+          std::shared_ptr<TinyPBProtocol> response = std::dynamic_pointer_cast<TinyPBProtocol>(result[i]);
+          if (response)
+          {
+            response->detach();
+          }
           it->second(result[i]);
           m_read_dones.erase(it);
         }
@@ -158,8 +246,117 @@ namespace rocket
 
   void TcpConnection::reply(std::vector<AbstractProtocol::s_ptr> &replay_messages)
   {
-    m_coder->encode(replay_messages, m_out_buffer);
-    listenWrite();
+    // 不在 IO 线程里时不能操作发送队列和 socket，整个回包投递到 IO 线程的回包队列
+    if (!m_event_loop->isInLoopThread())
+    {
+      std::vector<AbstractProtocol::s_ptr> messages = replay_messages;
+      TcpConnection::s_ptr self = shared_from_this();
+      m_event_loop->addTask([self, messages]() mutable
+                            { self->reply(messages); },
+                            true, TaskPriorityReply);
+      return;
+    }
+
+    // 发送队列里还有没发完的数据，说明内核发送缓冲区是满的，已经在等可写事件
+    bool is_pending = !m_out_queue->empty();
+
+    m_pending_replies -= replay_messages.size();
+    m_coder->encode(replay_messages, m_out_queue);
+    m_last_write_us = Clock::CachedUs();
+
+    flushOutQueue(is_pending);
+  }
+
+  void TcpConnection::flushOutQueue(bool is_pending)
+  {
+    // 新数据追加到发送队列后由 onWrite 一起发送
+    if (is_pending)
+    {
+      return;
+    }
+
+    if (submitOutQueue())
+    {
+      rearm();
+      return;
+    }
+
+    // 先直接写，只有内核发送缓冲区写满(EAGAIN)时才监听可写事件，
+    // 绝大多数小响应一次 write 就能发完，省掉打开/关闭 EPOLLOUT 的两次 epoll_ctl 和一轮 loop
+    bool is_write_all = sendOutQueue();
+    if (m_state != Connected)
+    {
+      return;
+    }
+    if (m_fd_event->isOneShot())
+    {
+      // 交给 worker 的请求回包写出去之后才重新打开监听，可读和可写由 rearm 一起决定
+      if (!is_write_all)
+      {
+        m_fd_event->listen(FdEvent::OUT_EVENT, std::bind(&TcpConnection::onWrite, this));
+      }
+      rearm();
+    }
+    else if (!is_write_all)
+    {
+      listenWrite();
+    }
+  }
+
+  bool TcpConnection::submitOutQueue()
+  {
+    if (!m_fd_event->isAsyncIo() || m_out_queue->empty() || !m_event_loop->getPoller()->supportAsyncIo())
+    {
+      return false;
+    }
+    struct iovec vec[TcpOutputQueue::MAX_IOV];
+    int count = m_out_queue->fillIov(vec, TcpOutputQueue::MAX_IOV);
+    if (count == 0)
+    {
+      // 已经有一个写在进行，完成之后会接着发
+      return true;
+    }
+    // 队列自己作为 holder，连接在写完成之前关闭也不会释放分段
+    if (m_event_loop->getPoller()->submitWrite(m_fd_event, vec, count, m_out_queue))
+    {
+      return true;
+    }
+    m_out_queue->finishWrite(0);
+    return false;
+  }
+
+  /// @brief 把发送队列里的数据尽量写到 socket，写完返回 true，遇到 EAGAIN 或出错返回 false
+  bool TcpConnection::sendOutQueue()
+  {
+    while (true)
+    {
+      if (m_out_queue->empty())
+      {
+        DEBUGLOG("no data need to send to ip: [%s]", m_peer_addr->toString().c_str());
+        return true;
+      }
+
+      // 一次 writev 发出帧头和引用的 pb_data，发出去的部分队列自己去掉，部分写时下一次循环接着发
+      int rt = m_out_queue->writeToFd(m_fd);
+
+      if (rt > 0)
+      {
+        continue;
+      }
+      if (rt == -1 && errno == EINTR)
+      {
+        continue;
+      }
+      if (rt == -1 && errno == EAGAIN)
+      {
+        // 发送缓冲区已满，不能再发送了。
+        // 这种情况我们等下次 fd 可写的时候再次发送数据即可
+        DEBUGLOG("write data error, errno==EAGIN and rt == -1");
+        return false;
+      }
+      ERRORLOG("write data error, errno=%d, error=%s, clientfd[%d]", errno, strerror(errno), m_fd);
+      return false;
+    }
   }
 
 
@@ -169,7 +366,7 @@ namespace rocket
   */
   void TcpConnection::onWrite()
   {
-    // 将当前 out_buffer 里面的数据全部发送给 client
+    // 将当前发送队列里面的数据全部发送给 client
 
     if (m_state != Connected)
     {
@@ -177,6 +374,21 @@ namespace rocket
       return;
     }
 
+    // 异步写完成：去掉写出去的部分，剩下的继续发
+    int write_rt = 0;
+    if (m_fd_event->isAsyncIo() && m_event_loop->getPoller()->takeWriteResult(m_fd_event, write_rt))
+    {
+      m_out_queue->finishWrite(write_rt > 0 ? write_rt : 0);
+      if (write_rt < 0 && write_rt != -EINTR)
+      {
+        ERRORLOG("write data error, errno=%d, error=%s, clientfd[%d]", -write_rt, strerror(-write_rt), m_fd);
+        clear();
+        return;
+      }
+      flushOutQueue(false);
+      return;
+    }
+
     //只有在client端才执行
     if (m_connection_type == TcpConnectionByClient)
     {
@@ -191,45 +403,24 @@ namespace rocket
         messages.push_back(m_write_dones[i].first);
       }
 
-      //将信息编码之后写入到buffer当中
-      m_coder->encode(messages, m_out_buffer);
+      //将信息编码之后写入到发送队列当中
+      m_coder->encode(messages, m_out_queue);
     }
 
     //开始往对端发送buffer里面的数据
-    bool is_write_all = false;
-    while (true)
-    {
-      if (m_out_buffer->readAble() == 0)
-      {
-        DEBUGLOG("no data need to send to ip: [%s]", m_peer_addr->toString().c_str());
-        is_write_all = true;
-        break;
-      }
-      int write_size = m_out_buffer->readAble();
-      int read_index = m_out_buffer->readIndex();
-
-      int rt = write(m_fd, &(m_out_buffer->m_buffer[read_index]), write_size);
+    bool is_write_all = sendOutQueue();
 
-      if (rt >= write_size)
-      {
-        DEBUGLOG("no data need to send to client [%s]", m_peer_addr->toString().c_str());
-        is_write_all = true;
-        break;
-      }
-      if (rt == -1 && errno == EAGAIN)
-      {
-        // 发送缓冲区已满，不能再发送了。
-        // 这种情况我们等下次 fd 可写的时候再次发送数据即可
-        ERRORLOG("write data error, errno==EAGIN and rt == -1");
-        break;
-      }
-    }
     // 写完了就要关闭监听套接字的写事件，防止重复触发
-    if (is_write_all)
+    // 边缘触发只在 fd 从不可写变为可写时通知一次，保持监听不会空转，省掉一次 epoll_ctl
+    if (is_write_all && !m_fd_event->isEdgeTriggered() && !m_fd_event->isOneShot())
     {
       m_fd_event->cancle(FdEvent::OUT_EVENT);
       m_event_loop->addEpollEvent(m_fd_event);
     }
+    else
+    {
+      rearm();
+    }
 
     //只有在client端才执行，这一步是消息成功发送后执行回调函数
     if (m_connection_type == TcpConnectionByClient)
@@ -273,6 +464,75 @@ namespace rocket
 
     //状态设置为关闭
     m_state = Closed;
+
+    if (m_is_counted)
+    {
+      m_event_loop->updateConnectionCount(-1);
+      m_is_counted = false;
+    }
+
+    if (m_close_callback)
+    {
+      std::function<void(TcpConnection::s_ptr)> cb;
+      cb.swap(m_close_callback);
+      cb(shared_from_this());
+    }
+  }
+
+  void TcpConnection::setCloseCallback(std::function<void(TcpConnection::s_ptr)> cb)
+  {
+    m_close_callback = cb;
+  }
+
+  int64_t TcpConnection::getLastReadUs()
+  {
+    return m_last_read_us;
+  }
+
+  int64_t TcpConnection::getLastWriteUs()
+  {
+    return m_last_write_us;
+  }
+
+  int64_t TcpConnection::getLastHeartbeatUs()
+  {
+    return m_last_heartbeat_us;
+  }
+
+  void TcpConnection::sendHeartbeat()
+  {
+    if (m_state != Connected)
+    {
+      return;
+    }
+    m_last_heartbeat_us = Clock::CachedUs();
+
+    bool is_pending = !m_out_queue->empty();
+    std::vector<AbstractProtocol::s_ptr> messages;
+    messages.push_back(TinyPBProtocol::CreateHeartbeat(true));
+    m_coder->encode(messages, m_out_queue);
+    flushOutQueue(is_pending);
+  }
+
+  bool TcpConnection::handleHeartbeat(AbstractProtocol::s_ptr message)
+  {
+    std::shared_ptr<TinyPBProtocol> frame = std::dynamic_pointer_cast<TinyPBProtocol>(message);
+    if (!frame || !frame->isHeartbeat())
+    {
+      return false;
+    }
+
+    // 收到 ping 立刻回 pong，和 reply 一样发不完就监听可写事件，保证队列非空时 EPOLLOUT 一定打开着；
+    // 收到 pong 什么都不用做，读到数据已经刷新了活跃时间
+    if (frame->isHeartbeatPing())
+    {
+      bool is_pending = !m_out_queue->empty();
+      std::vector<AbstractProtocol::s_ptr> messages;
+      messages.push_back(TinyPBProtocol::CreateHeartbeat(false));
+      m_coder->encode(messages, m_out_queue);
+      flushOutQueue(is_pending);
+    }
+    return true;
   }
 
   /// @brief 服务器主动关闭连接
@@ -313,12 +573,40 @@ namespace rocket
     m_event_loop->addEpollEvent(m_fd_event);
   }
 
+  /// @brief EPOLLONESHOT 模式下事件触发一次就被禁用，处理完之后重新打开监听
+  /// 请求交给 worker 时 onRead 结束不会打开可读，worker 的回包经 reply 投递回 IO 线程，写出去之后在这里重新打开
+  void TcpConnection::rearm()
+  {
+    if (!m_fd_event->isOneShot() || m_state != Connected || m_is_reading)
+    {
+      return;
+    }
+    // 发送队列空了就不再等可写，否则 fd 一直可写，每次打开都会立刻触发一次
+    if (m_out_queue->empty())
+    {
+      m_fd_event->cancle(FdEvent::OUT_EVENT);
+    }
+    if (m_pending_replies == 0)
+    {
+      m_fd_event->listen(FdEvent::IN_EVENT, std::bind(&TcpConnection::onRead, this));
+    }
+    else
+    {
+      m_fd_event->cancle(FdEvent::IN_EVENT);
+    }
+    if (m_fd_event->getEpollEvent().events & (EPOLLIN | EPOLLOUT))
+    {
+      m_event_loop->addEpollEvent(m_fd_event);
+    }
+  }
+
   /// @brief 将RPC请求以及回调写入connection当中的buffer
   /// @param message 
   /// @param done 
   void TcpConnection::pushSendMessage(AbstractProtocol::s_ptr message, std::function<void(AbstractProtocol::s_ptr)> done)
   {
     m_write_dones.push_back(std::make_pair(message, done));
+    m_last_write_us = Clock::CachedUs();
   }
 
   void TcpConnection::pushReadMessage(const std::string &msg_id, std::function<void(AbstractProtocol::s_ptr)> done)
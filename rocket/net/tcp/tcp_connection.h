@@ -6,6 +6,7 @@
 #include <queue>
 #include "rocket/net/tcp/net_addr.h"
 #include "rocket/net/tcp/tcp_buffer.h"
+#include "rocket/net/tcp/tcp_output_queue.h"
 #include "rocket/net/io_thread.h"
 #include "rocket/net/coder/abstract_coder.h"
 #include "rocket/net/rpc/rpc_dispatcher.h"
@@ -27,7 +28,7 @@ namespace rocket
     TcpConnectionByClient = 2, // 作为客户端使用，代表跟对端服务端的连接
   };
 
-  class TcpConnection
+  class TcpConnection : public std::enable_shared_from_this<TcpConnection>
   {
   public:
     typedef std::shared_ptr<TcpConnection> s_ptr;
@@ -62,6 +63,10 @@ namespace rocket
     // 启动监听可读事件
     void listenRead();
 
+    // EPOLLONESHOT 模式下重新打开监听，其他模式什么都不做。
+    // 还有请求没回包时只在发送队列非空时监听可写，不监听可读，等 reply 把最后一个回包写出去之后再打开。只能在 IO 线程调用
+    void rearm();
+
     void pushSendMessage(AbstractProtocol::s_ptr message, std::function<void(AbstractProtocol::s_ptr)> done);
 
     void pushReadMessage(const std::string &msg_id, std::function<void(AbstractProtocol::s_ptr)> done);
@@ -72,6 +77,32 @@ namespace rocket
 
     void reply(std::vector<AbstractProtocol::s_ptr> &replay_messages);
 
+    // clear() 把连接置为 Closed 之后调用，在 IO 线程里执行
+    void setCloseCallback(std::function<void(TcpConnection::s_ptr)> cb);
+
+    // 最近一次读到数据 / 写出业务数据的时间，单调时钟 us；心跳不算写
+    int64_t getLastReadUs();
+
+    int64_t getLastWriteUs();
+
+    int64_t getLastHeartbeatUs();
+
+    // 发送一个心跳 ping，只能在 IO 线程调用
+    void sendHeartbeat();
+
+  private:
+    bool sendOutQueue();
+
+    // 把发送队列交给 Poller 异步写，写完成后在 onWrite 里接着发；后端不支持时返回 false，由调用方自己写
+    bool submitOutQueue();
+
+    // 新数据编码进发送队列之后调用，is_pending 是编码之前队列是否非空。
+    // 之前是空的就直接写，写不完再监听可写事件；之前非空说明已经在等可写事件，由 onWrite 一起发送
+    void flushOutQueue(bool is_pending);
+
+    // 心跳帧在这里处理掉，不交给 RPC 分发或回调，是心跳时返回 true
+    bool handleHeartbeat(AbstractProtocol::s_ptr message);
+
   private:
     EventLoop *m_event_loop{NULL}; // 代表持有该连接的 IO 线程
 
@@ -79,7 +110,7 @@ namespace rocket
     NetAddr::s_ptr m_peer_addr;
 
     TcpBuffer::s_ptr m_in_buffer;  // 接收缓冲区
-    TcpBuffer::s_ptr m_out_buffer; // 发送缓冲区
+    TcpOutputQueue::s_ptr m_out_queue; // 发送队列，writev 发送
 
     FdEvent *m_fd_event{NULL};
 
@@ -91,6 +122,18 @@ namespace rocket
 
     TcpConnectionType m_connection_type{TcpConnectionByServer};
 
+    bool m_is_counted{false}; // 是否计入了 m_event_loop 的连接数，关闭或析构时减掉
+
+    int m_pending_replies{0}; // 已经分发、还没有回包的请求数，只在 IO 线程修改
+
+    bool m_is_reading{false}; // 正在 onRead 里处理，期间的回包不重新打开监听，由 onRead 结束时统一处理
+
+    std::function<void(TcpConnection::s_ptr)> m_close_callback;
+
+    int64_t m_last_read_us{0};
+    int64_t m_last_write_us{0};
+    int64_t m_last_heartbeat_us{0};
+
     // std::pair<AbstractProtocol::s_ptr, std::function<void(AbstractProtocol::s_ptr)>>
     std::vector<std::pair<AbstractProtocol::s_ptr, std::function<void(AbstractProtocol::s_ptr)>>> m_write_dones;
 
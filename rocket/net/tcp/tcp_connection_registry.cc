@@ -0,0 +1,93 @@
+#include "rocket/net/tcp/tcp_connection_registry.h"
+#include <algorithm>
+#include "rocket/common/log.h"
+
+namespace rocket
+{
+
+  TcpConnectionRegistry::TcpConnectionRegistry(EventLoop *event_loop) : m_event_loop(event_loop)
+  {
+  }
+
+  TcpConnectionRegistry::~TcpConnectionRegistry()
+  {
+  }
+
+  void TcpConnectionRegistry::add(TcpConnection::s_ptr connection)
+  {
+    int fd = connection->getFd();
+    if (fd < 0)
+    {
+      return;
+    }
+    if ((size_t)fd >= m_connections.size())
+    {
+      m_connections.resize(std::max((size_t)fd + 1, m_connections.size() * 2));
+    }
+    if (!m_connections[fd])
+    {
+      ++m_size;
+    }
+    m_connections[fd] = connection;
+
+    connection->setCloseCallback([this](TcpConnection::s_ptr conn)
+                                 { remove(conn); });
+  }
+
+  void TcpConnectionRegistry::remove(TcpConnection::s_ptr connection)
+  {
+    int fd = connection->getFd();
+    if (fd < 0 || (size_t)fd >= m_connections.size() || m_connections[fd] != connection)
+    {
+      return;
+    }
+
+    DEBUGLOG("TcpConection [fd:%d] will delete, state=%d", fd, connection->getState());
+    m_connections[fd].reset();
+    --m_size;
+
+    if (m_remove_callback)
+    {
+      m_remove_callback(connection);
+    }
+
+    // 删除通常发生在连接自己的读写回调里，这一轮 loop 结束后再释放
+    m_event_loop->addTask([connection]() {}, false, TaskPriorityBackground);
+  }
+
+  TcpConnection::s_ptr TcpConnectionRegistry::get(int fd)
+  {
+    if (fd < 0 || (size_t)fd >= m_connections.size())
+    {
+      return nullptr;
+    }
+    return m_connections[fd];
+  }
+
+  size_t TcpConnectionRegistry::size()
+  {
+    return m_size;
+  }
+
+  void TcpConnectionRegistry::forEach(const std::function<void(TcpConnection::s_ptr)> &cb)
+  {
+    for (size_t i = 0; i < m_connections.size(); ++i)
+    {
+      if (m_connections[i])
+      {
+        cb(m_connections[i]);
+      }
+    }
+  }
+
+  EventLoop *TcpConnectionRegistry::getEventLoop()
+  {
+    return m_event_loop;
+  }
+
+  void TcpConnectionRegistry::setRemoveCallback(std::function<void(TcpConnection::s_ptr)> cb)
+  {
+    m_remove_callback = cb;
+  }
+
+}
@@ -0,0 +1,52 @@
+#ifndef ROCKET_NET_TCP_TCP_CONNECTION_REGISTRY_H
+#define ROCKET_NET_TCP_TCP_CONNECTION_REGISTRY_H
+
+#include <vector>
+#include <functional>
+#include "rocket/net/eventloop.h"
+#include "rocket/net/tcp/tcp_connection.h"
+
+namespace rocket
+{
+
+  /// @brief 一个 IO 线程上的服务端连接表，以 fd 为下标，增删都是 O(1)
+  /// 只允许在所属 EventLoop 的线程里访问。连接关闭时立刻从表里摘掉，
+  /// 连接对象延迟到下一轮 loop 再析构，避免在它自己的回调里被释放。
+  class TcpConnectionRegistry
+  {
+  public:
+    TcpConnectionRegistry(EventLoop *event_loop);
+
+    ~TcpConnectionRegistry();
+
+    // 加入连接，并在连接关闭时自动删除
+    void add(TcpConnection::s_ptr connection);
+
+    // 表里是同一个连接时才删除，fd 被新连接复用后旧连接的删除不影响新连接
+    void remove(TcpConnection::s_ptr connection);
+
+    TcpConnection::s_ptr get(int fd);
+
+    size_t size();
+
+    // 遍历当前所有连接
+    void forEach(const std::function<void(TcpConnection::s_ptr)> &cb);
+
+    EventLoop *getEventLoop();
+
+    // 连接从表里删除之后回调，在所属 IO 线程里执行
+    void setRemoveCallback(std::function<void(TcpConnection::s_ptr)> cb);
+
+  private:
+    EventLoop *m_event_loop{NULL};
+
+    std::vector<TcpConnection::s_ptr> m_connections; // 下标为 fd
+
+    size_t m_size{0};
+
+    std::function<void(TcpConnection::s_ptr)> m_remove_callback;
+  };
+
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include <sys/uio.h>
+#include "rocket/net/tcp/tcp_output_queue.h"
+
+namespace rocket
+{
+
+  const char *TcpOutputQueue::Segment::begin() const
+  {
+    return m_ref ? m_ref : m_data.data();
+  }
+
+  int TcpOutputQueue::Segment::size() const
+  {
+    return m_ref ? m_ref_size : (int)m_data.size();
+  }
+
+  TcpOutputQueue::TcpOutputQueue()
+  {
+  }
+
+  TcpOutputQueue::~TcpOutputQueue()
+  {
+  }
+
+  void TcpOutputQueue::append(const char *buf, int size)
+  {
+    if (size <= 0)
+    {
+      return;
+    }
+    // 队尾是没写满的拷贝分段就接着往里追加，即使它已经发出去了一部分，偏移也不受影响；
+    // 正在异步写的分段追加会让 string 重新分配，只能新开一个
+    if (m_segments.empty() || m_segments.back().m_ref || (int)m_segments.back().m_data.size() >= MAX_COPY_SEGMENT_SIZE || (int)m_segments.size() <= m_locked_count)
+    {
+      m_segments.push_back(Segment());
+    }
+    m_segments.back().m_data.append(buf, size);
+    m_size += size;
+  }
+
+  void TcpOutputQueue::appendRef(const char *buf, int size, std::shared_ptr<void> holder)
+  {
+    if (size < REF_MIN_SIZE || !holder)
+    {
+      append(buf, size);
+      return;
+    }
+    m_segments.push_back(Segment());
+    Segment &segment = m_segments.back();
+    segment.m_ref = buf;
+    segment.m_ref_size = size;
+    segment.m_holder = holder;
+    m_size += size;
+  }
+
+  int TcpOutputQueue::readAble()
+  {
+    return m_size;
+  }
+
+  bool TcpOutputQueue::empty()
+  {
+    return m_size == 0;
+  }
+
+  int TcpOutputQueue::writeToFd(int fd)
+  {
+    struct iovec vec[MAX_IOV];
+    int count = buildIov(vec, MAX_IOV);
+    if (count == 0)
+    {
+      return 0;
+    }
+
+    int rt = writev(fd, vec, count);
+    if (rt > 0)
+    {
+      consume(rt);
+    }
+    return rt;
+  }
+
+  int TcpOutputQueue::fillIov(struct iovec *vec, int max)
+  {
+    if (m_locked_count > 0)
+    {
+      return 0;
+    }
+    m_locked_count = buildIov(vec, max);
+    return m_locked_count;
+  }
+
+  void TcpOutputQueue::finishWrite(int size)
+  {
+    m_locked_count = 0;
+    if (size > 0)
+    {
+      consume(size);
+    }
+  }
+
+  int TcpOutputQueue::buildIov(struct iovec *vec, int max)
+  {
+    int count = 0;
+    for (std::deque<Segment>::iterator it = m_segments.begin(); it != m_segments.end() && count < max; ++it)
+    {
+      vec[count].iov_base = const_cast<char *>(it->begin() + it->m_offset);
+      vec[count].iov_len = it->size() - it->m_offset;
+      ++count;
+    }
+    return count;
+  }
+
+  void TcpOutputQueue::consume(int size)
+  {
+    m_size -= size;
+    while (size > 0 && !m_segments.empty())
+    {
+      Segment &front = m_segments.front();
+      int left = front.size() - front.m_offset;
+      if (size < left)
+      {
+        front.m_offset += size;
+        return;
+      }
+      size -= left;
+      m_segments.pop_front();
+    }
+  }
+
+}
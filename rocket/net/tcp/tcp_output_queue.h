@@ -0,0 +1,82 @@
+#ifndef ROCKET_NET_TCP_TCP_OUTPUT_QUEUE_H
+#define ROCKET_NET_TCP_TCP_OUTPUT_QUEUE_H
+
+#include <deque>
+#include <string>
+#include <memory>
+#include <sys/uio.h>
+
+namespace rocket
+{
+
+  /// @brief 连接的发送队列，由一串分段组成，用 writev 一次把多个分段写出去
+  /// 帧头这类小块数据拷贝进队列自己的分段，相邻的小块合并到同一个分段里；
+  /// 大块数据（比如 protobuf 的序列化结果）只保存指针，由 holder 保证发送完之前不被释放。
+  /// 部分写时记录分段内的偏移，EAGAIN 之后下一次从断点继续。只允许所属 IO 线程访问。
+  class TcpOutputQueue
+  {
+  public:
+    typedef std::shared_ptr<TcpOutputQueue> s_ptr;
+
+    TcpOutputQueue();
+
+    ~TcpOutputQueue();
+
+    // 拷贝 size 字节到队尾
+    void append(const char *buf, int size);
+
+    // 引用 [buf, buf + size)，holder 持有这块内存，发送完之前内容不能修改；
+    // 小于 REF_MIN_SIZE 的直接拷贝，不值得多占一个 iovec
+    void appendRef(const char *buf, int size, std::shared_ptr<void> holder);
+
+    // 待发送的字节数
+    int readAble();
+
+    bool empty();
+
+    // 用一次 writev 尽量多写，返回值和 errno 同 write，写出去的部分从队列里去掉
+    int writeToFd(int fd);
+
+    // 把队首最多 max 个分段填进 vec 交给异步写，返回填入的个数；
+    // 写完成之前这些分段被锁住，append 不再往里追加，也不能再调用 writeToFd
+    int fillIov(struct iovec *vec, int max);
+
+    // 异步写完成，去掉写出去的 size 字节并解锁，size 为 0 表示什么都没写出去
+    void finishWrite(int size);
+
+  public:
+    static const int REF_MIN_SIZE = 1024;
+
+    static const int MAX_IOV = 64;
+
+    static const int MAX_COPY_SEGMENT_SIZE = 64 * 1024; // 拷贝分段超过这个大小后新开一个，避免大字符串反复扩容
+
+  private:
+    struct Segment
+    {
+      std::string m_data;             // 拷贝进来的数据，m_ref 为空时有效
+      const char *m_ref{NULL};        // 引用的数据
+      int m_ref_size{0};
+      std::shared_ptr<void> m_holder; // 引用数据的所有者
+      int m_offset{0};                // 已经发送的字节数
+
+      const char *begin() const;
+
+      int size() const;
+    };
+
+    int buildIov(struct iovec *vec, int max);
+
+    void consume(int size);
+
+  private:
+    std::deque<Segment> m_segments;
+
+    int m_size{0};
+
+    int m_locked_count{0}; // 队首正在被异步写使用的分段数
+  };
+
+}
+
+#endif
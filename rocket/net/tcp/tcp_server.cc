@@ -1,8 +1,13 @@
+#include <sys/socket.h>
+#include <string.h>
+#include <errno.h>
 #include "rocket/net/tcp/tcp_server.h"
 #include "rocket/net/eventloop.h"
 #include "rocket/net/tcp/tcp_connection.h"
 #include "rocket/common/log.h"
 #include "rocket/common/config.h"
+#include "rocket/common/cpu_affinity.h"
+#include "rocket/net/fd_event_group.h"
 
 namespace rocket
 {
@@ -27,57 +32,308 @@ namespace rocket
       delete m_io_thread_group;
       m_io_thread_group = NULL;
     }
-    if (m_listen_fd_event)
+    for (size_t i = 0; i < m_listeners.size(); ++i)
     {
-      delete m_listen_fd_event;
-      m_listen_fd_event = NULL;
+      delete m_listeners[i]->m_fd_event;
+      delete m_listeners[i];
     }
+    m_listeners.clear();
+    if (m_admission_controller)
+    {
+      delete m_admission_controller;
+      m_admission_controller = NULL;
+    }
+    for (size_t i = 0; i < m_idle_managers.size(); ++i)
+    {
+      delete m_idle_managers[i];
+    }
+    m_idle_managers.clear();
+    for (size_t i = 0; i < m_connection_registries.size(); ++i)
+    {
+      delete m_connection_registries[i];
+    }
+    m_connection_registries.clear();
   }
 
   void TcpServer::init()
   {
 
-    m_acceptor = std::make_shared<TcpAcceptor>(m_local_addr);
-
     //构造一个主reactor对象
     m_main_event_loop = EventLoop::GetCurrentEventLoop();
     //构造IOThreadGroup对象，里面封装了指定大小个subReactor
     m_io_thread_group = new IOThreadGroup(Config::GetGlobalConfig()->m_io_threads);
+    int idle_timeout_ms = Config::GetGlobalConfig()->m_idle_timeout_ms;
+    int heartbeat_interval_ms = Config::GetGlobalConfig()->m_heartbeat_interval_ms;
+    m_admission_controller = new AdmissionController(m_io_thread_group, Config::GetGlobalConfig()->m_max_connections, Config::GetGlobalConfig()->m_max_connections_per_thread,
+                                                     Config::GetGlobalConfig()->m_max_connections_per_ip, Config::GetGlobalConfig()->m_over_limit_action);
+    for (int i = 0; i < m_io_thread_group->size(); ++i)
+    {
+      EventLoop *io_event_loop = m_io_thread_group->getIOThreadAt(i)->getEventLoop();
+      TcpConnectionRegistry *registry = new TcpConnectionRegistry(io_event_loop);
+      registry->setRemoveCallback(std::bind(&TcpServer::onConnectionRemoved, this, std::placeholders::_1));
+      m_connection_registries.push_back(registry);
+      if (idle_timeout_ms > 0 || heartbeat_interval_ms > 0)
+      {
+        m_idle_managers.push_back(new IdleConnectionManager(io_event_loop, idle_timeout_ms, heartbeat_interval_ms));
+      }
+    }
+    // IO 线程创建之后再给主线程绑核，否则 IO 线程会继承主线程的 cpu 集合
+    if (!bindCurrentThreadToCpus(Config::GetGlobalConfig()->m_acceptor_cpus))
+    {
+      ERRORLOG("acceptor bind to cpus [%s] error, errno=%d, error=%s", cpuListToString(Config::GetGlobalConfig()->m_acceptor_cpus).c_str(), errno, strerror(errno));
+    }
+    else if (!Config::GetGlobalConfig()->m_acceptor_cpus.empty() && Config::GetGlobalConfig()->m_numa_local && !setNumaLocalPolicy())
+    {
+      ERRORLOG("acceptor set numa local memory policy error, errno=%d, error=%s", errno, strerror(errno));
+    }
+
+    if (Config::GetGlobalConfig()->m_busy_poll_us > 0)
+    {
+      m_io_thread_group->setBusyPoll(Config::GetGlobalConfig()->m_busy_poll_us, Config::GetGlobalConfig()->m_busy_poll_density);
+    }
+
+    if (Config::GetGlobalConfig()->m_reuse_port)
+    {
+      initReusePortAcceptors();
+    }
+    else
+    {
+      //挂载到主线程的epoll句柄上，这正好印证了主线程负责监听新用户连接
+      addListener(std::make_shared<TcpAcceptor>(m_local_addr, false, Config::GetGlobalConfig()->m_listen_backlog), m_main_event_loop, NULL);
+    }
+  }
+
+  TcpServer::Listener *TcpServer::addListener(TcpAcceptor::s_ptr acceptor, EventLoop *event_loop, IOThread *io_thread)
+  {
+    Listener *listener = new Listener();
+    listener->m_acceptor = acceptor;
+    listener->m_event_loop = event_loop;
+    listener->m_io_thread = io_thread;
+    //根据监听套接字构造一个封装好的fd_event，绑定读事件以及回调函数
+    listener->m_fd_event = new FdEvent(acceptor->getListenFd());
+    listener->m_fd_event->listen(FdEvent::IN_EVENT, std::bind(&TcpServer::onAccept, this, listener));
+    event_loop->addEpollEvent(listener->m_fd_event);
+
+    m_listeners.push_back(listener);
+    return listener;
+  }
 
-    //根据监听套接字构造一个封装好的fd_event
-    m_listen_fd_event = new FdEvent(m_acceptor->getListenFd());
-    //绑定读事件以及回调函数
-    m_listen_fd_event->listen(FdEvent::IN_EVENT, std::bind(&TcpServer::onAccept, this));
-    //挂载到epoll句柄上，执行这段代码肯定是主线程，自然而然就是挂载到主线程的epoll句柄上，这正好印证了主线程负责监听新用户连接
-    m_main_event_loop->addEpollEvent(m_listen_fd_event);
+  void TcpServer::initReusePortAcceptors()
+  {
+    // 在主线程里按 IO 线程的顺序依次 bind，组内第 i 个 socket 就是第 i 个 IO 线程的，CBPF 按这个下标选 socket
+    int size = m_io_thread_group->size();
+    for (int i = 0; i < size; ++i)
+    {
+      IOThread *io_thread = m_io_thread_group->getIOThreadAt(i);
+      addListener(std::make_shared<TcpAcceptor>(m_local_addr, true, Config::GetGlobalConfig()->m_listen_backlog), io_thread->getEventLoop(), io_thread);
+    }
 
-    //设置定时任务，回调函数是ClearClientTimerFunc，这个函数用来定时清除已经关闭的连接
-    m_clear_client_timer_event = std::make_shared<TimerEvent>(5000, true, std::bind(&TcpServer::ClearClientTimerFunc, this));
-    m_main_event_loop->addTimerEvent(m_clear_client_timer_event);
+    if (Config::GetGlobalConfig()->m_reuse_port_cbpf && size > 0)
+    {
+      if (m_listeners[0]->m_acceptor->attachCpuSteeringFilter(size))
+      {
+        INFOLOG("attach reuseport cpu steering cbpf, group size=%d", size);
+      }
+    }
+    INFOLOG("TcpServer use %d SO_REUSEPORT acceptors", size);
   }
 
-  void TcpServer::onAccept()
+  void TcpServer::onAccept(Listener *listener)
   {
-    //主动调用封装好的accept函数，获得通信套接字client_fd,以及对端信息{元组形式}
-    auto re = m_acceptor->accept();
-    int client_fd = re.first;
-    NetAddr::s_ptr peer_addr = re.second;
+    // 监听 fd 是非阻塞、水平触发的，一次唤醒里一直 accept 到 EAGAIN，最多 m_max_accept_per_wakeup 个，
+    // 剩下的留给下一轮 loop，不让 accept 风暴饿死同一个 loop 上的其他事件
+    int max_accept = Config::GetGlobalConfig()->m_max_accept_per_wakeup;
+    int so_busy_poll_us = Config::GetGlobalConfig()->m_so_busy_poll_us;
+    AdmissionController::OverLimitAction action = m_admission_controller->getOverLimitAction();
+
+    // 按目标 IO 线程分批，每个线程只投递一个创建连接的任务
+    std::vector<std::pair<IOThread *, std::vector<std::pair<int, NetAddr::s_ptr>>>> batches;
+
+    int accept_count = 0;
+    int refuse_count = 0;
+    while (max_accept <= 0 || accept_count + refuse_count < max_accept)
+    {
+      // pause 模式下超限就不再 accept，让连接在内核队列里等，队列满了之后对端的 SYN 会被丢弃重传
+      if (action == AdmissionController::OverLimitPause && isOverLimit(listener))
+      {
+        pauseListener(listener);
+        break;
+      }
+
+      //主动调用封装好的accept函数，获得通信套接字client_fd,以及对端信息{元组形式}
+      auto re = listener->m_acceptor->accept();
+      int client_fd = re.first;
+      NetAddr::s_ptr peer_addr = re.second;
+      if (client_fd < 0)
+      {
+        break;
+      }
+
+      // 把 clientfd 添加到任意 IO 线程里面，即在主线程当中有新用户连接时，就会将生成的通信套接字分发给任意subReactor当中去
+      IOThread *target = selectIOThread(listener, peer_addr);
+      if (target == NULL || !m_admission_controller->acquirePeer(peer_addr))
+      {
+        // 单 ip 超限或者 pause 模式下的竞争，只能拒绝这一个连接
+        ++refuse_count;
+        m_admission_controller->refuse(client_fd, action != AdmissionController::OverLimitClose);
+        continue;
+      }
+      ++accept_count;
+
+      if (so_busy_poll_us > 0 && setsockopt(client_fd, SOL_SOCKET, SO_BUSY_POLL, &so_busy_poll_us, sizeof(so_busy_poll_us)) != 0)
+      {
+        ERRORLOG("set SO_BUSY_POLL error, fd=%d, errno=%d, error=%s", client_fd, errno, strerror(errno));
+      }
+
+      // fd_event 是按 fd 复用的，每次都要重新设置触发方式，TcpConnection 注册监听时会带上
+      FdEvent *client_fd_event = FdEventGroup::GetFdEventGroup()->getFdEvent(client_fd);
+      client_fd_event->setEdgeTriggered(Config::GetGlobalConfig()->m_edge_triggered);
+      client_fd_event->setOneShot(Config::GetGlobalConfig()->m_one_shot);
+
+      // 放置时就计入连接数，同一批里后面的连接选线程、做准入检查时能看到前面的
+      target->getEventLoop()->updateConnectionCount(1);
+
+      size_t i = 0;
+      while (i < batches.size() && batches[i].first != target)
+      {
+        ++i;
+      }
+      if (i == batches.size())
+      {
+        batches.push_back(std::make_pair(target, std::vector<std::pair<int, NetAddr::s_ptr>>()));
+      }
+      batches[i].second.push_back(re);
+    }
 
+    if (refuse_count > 0)
+    {
+      INFOLOG("TcpServer refuse %d clients, over connection limit", refuse_count);
+    }
+    if (accept_count == 0)
+    {
+      return;
+    }
     //记录连接的用户数
-    m_client_counts++;
+    m_client_counts += accept_count;
+
+    for (size_t i = 0; i < batches.size(); ++i)
+    {
+      newConnections(getIOThreadIndex(batches[i].first), batches[i].second);
+    }
+    INFOLOG("TcpServer succ get %d clients", accept_count);
+  }
+
+  bool TcpServer::isOverLimit(Listener *listener)
+  {
+    if (m_admission_controller->isFull())
+    {
+      return true;
+    }
+    if (listener->m_io_thread)
+    {
+      return m_admission_controller->isThreadFull(listener->m_io_thread);
+    }
+    return m_admission_controller->findAvailableThread(NULL) == NULL;
+  }
+
+  IOThread *TcpServer::selectIOThread(Listener *listener, NetAddr::s_ptr peer_addr)
+  {
+    if (m_admission_controller->isFull())
+    {
+      return NULL;
+    }
+    // reuseport 模式下连接已经在这个 IO 线程的监听 socket 上了，不能转给别的线程
+    if (listener->m_io_thread)
+    {
+      return m_admission_controller->isThreadFull(listener->m_io_thread) ? NULL : listener->m_io_thread;
+    }
+    // 放置策略选中的线程满了就换一个没满的
+    return m_admission_controller->findAvailableThread(m_io_thread_group->getIOThread(peer_addr));
+  }
+
+  void TcpServer::pauseListener(Listener *listener)
+  {
+    if (listener->m_paused.exchange(true))
+    {
+      return;
+    }
+    ++m_paused_count;
+    listener->m_event_loop->deleteEpollEvent(listener->m_fd_event);
+    INFOLOG("TcpServer pause accept on listen fd %d, over connection limit", listener->m_acceptor->getListenFd());
 
-    // 把 clientfd 添加到任意 IO 线程里面，即在主线程当中有新用户连接时，就会将生成的通信套接字分发给任意subReactor当中去
-    IOThread *io_thread = m_io_thread_group->getIOThread();
-    TcpConnection::s_ptr connetion = std::make_shared<TcpConnection>(io_thread->getEventLoop(), client_fd, 128, peer_addr, m_local_addr);
-    //设置状态为已连接
-    connetion->setState(Connected);
+    // 在摘掉监听 fd 之前可能已经有连接关闭，它们看到的 m_paused_count 还是 0，这里补查一次
+    resumeListeners();
+  }
 
-    //将当前连接放入连接集合当中去
-    m_client.insert(connetion);
+  void TcpServer::resumeListeners()
+  {
+    for (size_t i = 0; i < m_listeners.size(); ++i)
+    {
+      Listener *listener = m_listeners[i];
+      if (!listener->m_paused)
+      {
+        continue;
+      }
+      // 暂停和恢复都在 listener 所在的 loop 里执行，不会交错
+      listener->m_event_loop->addTask([this, listener]()
+                                      {
+        if (!listener->m_paused || isOverLimit(listener))
+        {
+          return;
+        }
+        listener->m_paused = false;
+        --m_paused_count;
+        listener->m_event_loop->addEpollEvent(listener->m_fd_event);
+        INFOLOG("TcpServer resume accept on listen fd %d", listener->m_acceptor->getListenFd()); },
+                                      true);
+    }
+  }
 
-    INFOLOG("TcpServer succ get client, fd=%d", client_fd);
+  void TcpServer::onConnectionRemoved(TcpConnection::s_ptr connection)
+  {
+    m_admission_controller->releasePeer(connection->getPeerAddr());
+    if (m_paused_count > 0)
+    {
+      resumeListeners();
+    }
   }
 
+  void TcpServer::newConnections(int io_index, const std::vector<std::pair<int, NetAddr::s_ptr>> &clients)
+  {
+    NetAddr::s_ptr local_addr = m_local_addr;
+    TcpConnectionRegistry *registry = m_connection_registries[io_index];
+    IdleConnectionManager *idle_manager = m_idle_managers.empty() ? NULL : m_idle_managers[io_index];
+    EventLoop *io_event_loop = registry->getEventLoop();
+
+    // 连接对象在所属的 IO 线程里创建，连接和缓冲区的内存都在这个线程绑定的 NUMA 节点上；
+    // reuseport 模式下本来就在这个 IO 线程里，直接创建
+    io_event_loop->runInLoop([registry, idle_manager, io_event_loop, clients, local_addr]()
+                             {
+      for (size_t i = 0; i < clients.size(); ++i)
+      {
+        TcpConnection::s_ptr connetion = std::make_shared<TcpConnection>(io_event_loop, clients[i].first, 128, clients[i].second, local_addr);
+        //设置状态为已连接
+        connetion->setState(Connected);
+        //放入本线程的连接表，连接关闭时自动删除
+        registry->add(connetion);
+        if (idle_manager)
+        {
+          idle_manager->add(connetion);
+        }
+      } });
+  }
+
+  int TcpServer::getIOThreadIndex(IOThread *io_thread)
+  {
+    for (int i = 0; i < m_io_thread_group->size(); ++i)
+    {
+      if (m_io_thread_group->getIOThreadAt(i) == io_thread)
+      {
+        return i;
+      }
+    }
+    return 0;
+  }
 
   /// @brief 对外接口，启动函数
   void TcpServer::start()
@@ -86,24 +342,13 @@ namespace rocket
     m_main_event_loop->loop();
   }
 
-  /// @brief 定时任务的回调函数，定期清理已关闭连接的客户端
-  void TcpServer::ClearClientTimerFunc()
+  void TcpServer::forEachConnection(std::function<void(TcpConnection::s_ptr)> cb)
   {
-    auto it = m_client.begin();
-    for (it = m_client.begin(); it != m_client.end();)
+    for (size_t i = 0; i < m_connection_registries.size(); ++i)
     {
-      // TcpConnection::ptr s_conn = i.second;
-      // DebugLog << "state = " << s_conn->getState();
-      if ((*it) != nullptr && (*it).use_count() > 0 && (*it)->getState() == Closed)
-      {
-        // need to delete TcpConnection
-        DEBUGLOG("TcpConection [fd:%d] will delete, state=%d", (*it)->getFd(), (*it)->getState());
-        it = m_client.erase(it);
-      }
-      else
-      {
-        it++;
-      }
+      TcpConnectionRegistry *registry = m_connection_registries[i];
+      registry->getEventLoop()->runInLoop([registry, cb]()
+                                          { registry->forEach(cb); });
     }
   }
 
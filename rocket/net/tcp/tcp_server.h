@@ -1,9 +1,13 @@
 #ifndef ROCKET_NET_TCP_SERVER_H
 #define ROCKET_NET_TCP_SERVER_H
 
-#include <set>
+#include <vector>
+#include <atomic>
 #include "rocket/net/tcp/tcp_acceptor.h"
 #include "rocket/net/tcp/tcp_connection.h"
+#include "rocket/net/tcp/tcp_connection_registry.h"
+#include "rocket/net/tcp/idle_connection_manager.h"
+#include "rocket/net/tcp/admission_controller.h"
 #include "rocket/net/tcp/net_addr.h"
 #include "rocket/net/eventloop.h"
 #include "rocket/net/io_thread_group.h"
@@ -20,31 +24,72 @@ namespace rocket
 
     void start();
 
+    // 管理用：在每个 IO 线程里遍历它的全部连接，cb 会在不同的 IO 线程里并发执行
+    void forEachConnection(std::function<void(TcpConnection::s_ptr)> cb);
+
+  private:
+    // 一个监听 socket 以及它挂在哪个 loop 上
+    struct Listener
+    {
+      TcpAcceptor::s_ptr m_acceptor;
+      FdEvent *m_fd_event{NULL};
+      EventLoop *m_event_loop{NULL}; // accept 所在的 loop
+      IOThread *m_io_thread{NULL};   // reuseport 模式下连接固定交给这个 IO 线程，主线程 accept 时为空
+      std::atomic<bool> m_paused{false};
+    };
+
   private:
     void init();
 
-    // 当有新客户端连接之后需要执行
-    void onAccept();
+    // 每个 IO 线程一个 SO_REUSEPORT 的 acceptor，连接在接收它的 IO 线程里处理，不跨线程转交
+    void initReusePortAcceptors();
 
-    // 清除 closed 的连接
-    void ClearClientTimerFunc();
+    Listener *addListener(TcpAcceptor::s_ptr acceptor, EventLoop *event_loop, IOThread *io_thread);
 
-  private:
-    TcpAcceptor::s_ptr m_acceptor;
+    // 当有新客户端连接之后需要执行，listener 没有固定 IO 线程时按放置策略选一个
+    void onAccept(Listener *listener);
+
+    // 这个 listener 已经没有可以放新连接的 IO 线程，或者全局连接数已满
+    bool isOverLimit(Listener *listener);
+
+    // 为新连接选一个没有超限的 IO 线程，超限时返回 NULL
+    IOThread *selectIOThread(Listener *listener, NetAddr::s_ptr peer_addr);
+
+    // pause 模式下停止 accept，监听 fd 从 loop 上摘掉，新连接留在内核的 backlog 里
+    void pauseListener(Listener *listener);
 
+    // 有连接关闭后在 listener 所在的 loop 里检查，没有超限就重新开始 accept
+    void resumeListeners();
+
+    // 连接从 IO 线程的连接表里删除时调用
+    void onConnectionRemoved(TcpConnection::s_ptr connection);
+
+    // 在第 io_index 个 IO 线程里为一批已经 accept 的 fd 创建 TcpConnection
+    void newConnections(int io_index, const std::vector<std::pair<int, NetAddr::s_ptr>> &clients);
+
+    int getIOThreadIndex(IOThread *io_thread);
+
+  private:
     NetAddr::s_ptr m_local_addr; // 本地监听地址
 
     EventLoop *m_main_event_loop{NULL}; // mainReactor
 
     IOThreadGroup *m_io_thread_group{NULL}; // subReactor 组
 
-    FdEvent *m_listen_fd_event;
+    // 主线程 accept 时只有一个；reuseport 模式下第 i 个属于第 i 个 IO 线程
+    std::vector<Listener *> m_listeners;
+
+    std::atomic<int> m_paused_count{0};
+
+    AdmissionController *m_admission_controller{NULL};
 
-    int m_client_counts{0};
+    std::atomic<int> m_client_counts{0};
 
-    std::set<TcpConnection::s_ptr> m_client;
+    // 第 i 个 IO 线程的连接表，连接关闭时立刻删除
+    std::vector<TcpConnectionRegistry *> m_connection_registries;
 
-    TimerEvent::s_ptr m_clear_client_timer_event;
+    // 第 i 个 IO 线程的空闲检测，没有配置 idle_timeout 和 heartbeat 时为空
+    std::vector<IdleConnectionManager *> m_idle_managers;
   };
 
 }
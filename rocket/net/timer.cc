@@ -1,24 +1,62 @@
 #include <sys/timerfd.h>
+#include <unistd.h>
 #include <string.h>
+#include <algorithm>
 #include "rocket/net/timer.h"
+#include "rocket/net/eventloop.h"
 #include "rocket/common/log.h"
-#include "rocket/common/util.h"
+#include "rocket/common/clock.h"
 
 namespace rocket
 {
 
-  Timer::Timer() : FdEvent()
+  static int levelShift(int level)
+  {
+    return level == 0 ? 0 : 8 + 6 * (level - 1);
+  }
+
+  static int levelSize(int level)
+  {
+    return level == 0 ? 256 : 64;
+  }
+
+  // 这一层能容纳的最大 tick 差
+  static int64_t levelSpan(int level)
+  {
+    return (int64_t)levelSize(level) << levelShift(level);
+  }
+
+  Timer::Timer(EventLoop *event_loop) : FdEvent(), m_event_loop(event_loop)
   {
 
     m_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
     DEBUGLOG("timer fd=%d", m_fd);
 
+    for (int i = 0; i < LEVEL_COUNT; ++i)
+    {
+      m_wheels[i].assign(levelSize(i), NULL);
+    }
+    m_current_tick = Clock::MonotonicUs();
+
     // 把 fd 可读事件放到了 eventloop 上监听
     listen(FdEvent::IN_EVENT, std::bind(&Timer::onTimer, this));
   }
 
   Timer::~Timer()
   {
+    for (int i = 0; i < LEVEL_COUNT; ++i)
+    {
+      for (size_t j = 0; j < m_wheels[i].size(); ++j)
+      {
+        while (m_wheels[i][j])
+        {
+          TimerEvent::s_ptr event = m_wheels[i][j]->m_self;
+          unlink(event.get());
+          event->m_self.reset();
+          event->m_owner = NULL;
+        }
+      }
+    }
   }
 
   /// @brief timer_fd的回调函数
@@ -34,119 +72,274 @@ namespace rocket
         break;
       }
     }
+    m_armed_tick = -1;
 
     // 执行定时任务
-    int64_t now = getNowMs();
-
-    std::vector<TimerEvent::s_ptr> tmps;
-    std::vector<std::pair<int64_t, std::function<void()>>> tasks;
+    int64_t now = Clock::Update();
 
-    ScopeMutex<Mutex> lock(m_mutex);
-    auto it = m_pending_events.begin();
+    std::vector<TimerEvent::s_ptr> expired;
+    advance(now, expired);
 
-    for (it = m_pending_events.begin(); it != m_pending_events.end(); ++it)
+    // 需要把重复的Event 再次添加进去
+    std::vector<std::pair<int64_t, TimerEvent::s_ptr>> tasks;
+    for (size_t i = 0; i < expired.size(); ++i)
     {
-      if ((*it).first <= now)
+      TimerEvent::s_ptr event = expired[i];
+      tasks.push_back(std::make_pair(event->getArriveTimeUs(), event));
+      if (event->isRepeated())
       {
-        if (!(*it).second->isCancled())
-        {
-          tmps.push_back((*it).second);
-          tasks.push_back(std::make_pair((*it).second->getArriveTime(), (*it).second->getCallBack()));
-        }
+        // 调整 arriveTime，从上一次的到期时间往后推，不从 now 开始算
+        event->advanceArriveTime(now);
+        insert(event.get());
+        event->m_self = event;
       }
       else
       {
-        break;
+        event->m_owner = NULL;
       }
     }
 
-    m_pending_events.erase(m_pending_events.begin(), it);
-    lock.unlock();
+    resetArriveTime();
 
-    // 需要把重复的Event 再次添加进去
-    for (auto i = tmps.begin(); i != tmps.end(); ++i)
+    // 回调按 TimerEvent 的优先级放进任务队列，下一轮 loop 开头执行，后台任务不会挤占回包
+    for (auto i : tasks)
     {
-      if ((*i)->isRepeated())
+      std::function<void()> cb = i.second->getCallBack();
+      if (!cb)
       {
-        // 调整 arriveTime
-        (*i)->resetArriveTime();
-        addTimerEvent(*i);
+        continue;
       }
+      int64_t arrive_time = i.first;
+      EventLoopStats *stats = m_stats;
+      m_event_loop->addTask([cb, arrive_time, stats]()
+                            {
+        if (stats)
+        {
+          stats->m_timer_lateness_us.record(Clock::FastUs() - arrive_time);
+        }
+        cb(); },
+                            false, i.second->getPriority());
     }
+  }
 
-    resetArriveTime();
+  void Timer::setStats(EventLoopStats *stats)
+  {
+    m_stats = stats;
+  }
 
-    for (auto i : tasks)
+  void Timer::insert(TimerEvent *event, bool is_cascade /*= false*/)
+  {
+    // 已经处理过的 tick 不会再回来，过期的事件放到下一个 tick；
+    // 降级发生在处理 m_current_tick 这个槽之前，所以降级的事件可以落在当前 tick
+    int64_t expire = event->getArriveTimeUs();
+    int64_t min_tick = is_cascade ? m_current_tick : m_current_tick + 1;
+    if (expire < min_tick)
     {
-      if (i.second)
-      {
-        i.second();
-      }
+      expire = min_tick;
     }
+
+    int64_t delta = expire - m_current_tick;
+    int level = 0;
+    while (level < LEVEL_COUNT && delta >= levelSpan(level))
+    {
+      ++level;
+    }
+    if (level == LEVEL_COUNT)
+    {
+      // 超出时间轮跨度，先挂在最高层最远的位置，降级时按真实的到期时间重新放
+      level = LEVEL_COUNT - 1;
+      expire = m_current_tick + levelSpan(level) - 1;
+    }
+
+    int index = (int)((expire >> levelShift(level)) & (levelSize(level) - 1));
+    TimerEvent **slot = &m_wheels[level][index];
+    event->m_prev = NULL;
+    event->m_next = *slot;
+    if (*slot)
+    {
+      (*slot)->m_prev = event;
+    }
+    *slot = event;
+    event->m_slot = slot;
+    ++m_event_count;
   }
 
-  void Timer::resetArriveTime()
+  void Timer::unlink(TimerEvent *event)
   {
-    ScopeMutex<Mutex> lock(m_mutex);
-    auto tmp = m_pending_events;
-    lock.unlock();
-
-    if (tmp.size() == 0)
+    if (event->m_slot == NULL)
     {
       return;
     }
+    if (event->m_prev)
+    {
+      event->m_prev->m_next = event->m_next;
+    }
+    else
+    {
+      *event->m_slot = event->m_next;
+    }
+    if (event->m_next)
+    {
+      event->m_next->m_prev = event->m_prev;
+    }
+    event->m_prev = NULL;
+    event->m_next = NULL;
+    event->m_slot = NULL;
+    --m_event_count;
+  }
 
-    int64_t now = getNowMs();
+  void Timer::cascade(int level, int64_t tick)
+  {
+    int index = (int)((tick >> levelShift(level)) & (levelSize(level) - 1));
+    TimerEvent *event = m_wheels[level][index];
+    while (event)
+    {
+      TimerEvent *next = event->m_next;
+      unlink(event);
+      insert(event, true);
+      event = next;
+    }
+  }
 
-    auto it = tmp.begin();
-    int64_t inteval = 0;
-    if (it->second->getArriveTime() > now)
+  void Timer::advance(int64_t now, std::vector<TimerEvent::s_ptr> &expired)
+  {
+    while (m_current_tick < now)
     {
-      inteval = it->second->getArriveTime() - now;
+      // 中间没有事件的 tick 直接跳过
+      int64_t next = nextTick();
+      if (next < 0 || next > now)
+      {
+        m_current_tick = now;
+        break;
+      }
+      if (next <= m_current_tick)
+      {
+        next = m_current_tick + 1;
+      }
+
+      // 从高层往低层降级，降级下来的事件可能正好落在 next 这个槽里
+      m_current_tick = next;
+      for (int level = LEVEL_COUNT - 1; level > 0; --level)
+      {
+        if ((next & (((int64_t)1 << levelShift(level)) - 1)) == 0)
+        {
+          cascade(level, next);
+        }
+      }
+
+      TimerEvent **slot = &m_wheels[0][next & (levelSize(0) - 1)];
+      while (*slot)
+      {
+        TimerEvent::s_ptr event = (*slot)->m_self;
+        unlink(event.get());
+        event->m_self.reset();
+        if (!event->isCancled())
+        {
+          expired.push_back(event);
+        }
+        else
+        {
+          event->m_owner = NULL;
+        }
+      }
     }
-    else
+  }
+
+  int64_t Timer::nextTick()
+  {
+    if (m_event_count == 0)
     {
-      inteval = 100;
+      return -1;
     }
 
-    timespec ts;
-    memset(&ts, 0, sizeof(ts));
-    ts.tv_sec = inteval / 1000;
-    ts.tv_nsec = (inteval % 1000) * 1000000;
+    int64_t re = -1;
+    for (int i = 1; i <= levelSize(0); ++i)
+    {
+      int64_t tick = m_current_tick + i;
+      if (m_wheels[0][tick & (levelSize(0) - 1)])
+      {
+        re = tick;
+        break;
+      }
+    }
+
+    // 高层槽位在它覆盖的时间段开始时降级
+    for (int level = 1; level < LEVEL_COUNT; ++level)
+    {
+      int shift = levelShift(level);
+      for (int i = 1; i <= levelSize(level); ++i)
+      {
+        int64_t tick = ((m_current_tick >> shift) + i) << shift;
+        if (re != -1 && tick >= re)
+        {
+          break;
+        }
+        if (m_wheels[level][(tick >> shift) & (levelSize(level) - 1)])
+        {
+          re = tick;
+          break;
+        }
+      }
+    }
+    return re;
+  }
+
+  void Timer::resetArriveTime()
+  {
+    int64_t next = nextTick();
+    if (next == m_armed_tick)
+    {
+      return;
+    }
 
     itimerspec value;
     memset(&value, 0, sizeof(value));
-    value.it_value = ts;
 
-    int rt = timerfd_settime(m_fd, 0, &value, NULL);
+    // 用单调时钟的绝对时间，已经过期的时间点 timerfd 会立即触发
+    if (next != -1)
+    {
+      value.it_value.tv_sec = next / 1000000;
+      value.it_value.tv_nsec = (next % 1000000) * 1000;
+    }
+
+    // it_value 全为 0 时关闭 timerfd
+    int rt = timerfd_settime(m_fd, TFD_TIMER_ABSTIME, &value, NULL);
     if (rt != 0)
     {
       ERRORLOG("timerfd_settime error, errno=%d, error=%s", errno, strerror(errno));
     }
-    // DEBUGLOG("timer reset to %lld", now + inteval);
+    m_armed_tick = next;
+    // DEBUGLOG("timer reset to %lld", next);
   }
 
   void Timer::addTimerEvent(TimerEvent::s_ptr event)
   {
-    bool is_reset_timerfd = false;
+    if (!m_event_loop->isInLoopThread())
+    {
+      m_event_loop->addTask([this, event]()
+                            { addTimerEvent(event); },
+                            true);
+      return;
+    }
 
-    ScopeMutex<Mutex> lock(m_mutex);
-    if (m_pending_events.empty())
+    // 时间轮的链表指针只能由一个 loop 线程修改，已经挂在别的 EventLoop 上的事件不能再加
+    Timer *owner = NULL;
+    if (!event->m_owner.compare_exchange_strong(owner, this) && owner != this)
     {
-      is_reset_timerfd = true;
+      ERRORLOG("add TimerEvent error, it is already added to another EventLoop");
+      return;
     }
-    else
+
+    // 重复添加同一个事件时先摘掉原来的位置
+    unlink(event.get());
+    if (m_event_count == 0)
     {
-      auto it = m_pending_events.begin();
-      if ((*it).second->getArriveTime() > event->getArriveTime())
-      {
-        is_reset_timerfd = true;
-      }
+      m_current_tick = std::max(m_current_tick, Clock::CachedUs());
     }
-    m_pending_events.emplace(event->getArriveTime(), event);
-    lock.unlock();
+    insert(event.get());
+    event->m_self = event;
 
-    if (is_reset_timerfd)
+    if (m_armed_tick == -1 || event->getArriveTimeUs() < m_armed_tick)
     {
       resetArriveTime();
     }
@@ -156,27 +349,23 @@ namespace rocket
   {
     event->setCancled(true);
 
-    ScopeMutex<Mutex> lock(m_mutex);
-
-    auto begin = m_pending_events.lower_bound(event->getArriveTime());
-    auto end = m_pending_events.upper_bound(event->getArriveTime());
-
-    auto it = begin;
-    for (it = begin; it != end; ++it)
+    if (!m_event_loop->isInLoopThread())
     {
-      if (it->second == event)
-      {
-        break;
-      }
+      m_event_loop->addTask([this, event]()
+                            { deleteTimerEvent(event); },
+                            true);
+      return;
     }
 
-    if (it != end)
+    if (event->m_owner != this)
     {
-      m_pending_events.erase(it);
+      return;
     }
-    lock.unlock();
+    unlink(event.get());
+    event->m_self.reset();
+    event->m_owner = NULL;
 
     DEBUGLOG("success delete TimerEvent at arrive time %lld", event->getArriveTime());
   }
 
-}
\ No newline at end of file
+}
@@ -1,35 +1,72 @@
 #ifndef ROCKET_NET_TIMER_H
 #define ROCKET_NET_TIMER_H
 
-#include <map>
-#include "rocket/common/mutex.h"
+#include <vector>
 #include "rocket/net/fd_event.h"
 #include "rocket/net/timer_event.h"
+#include "rocket/net/eventloop_stats.h"
 
 namespace rocket
 {
 
+  class EventLoop;
+
+  /// @brief 分层时间轮，tick 为 1us，时间取单调时钟 Clock::MonotonicUs()
+  /// 第 0 层 256 个槽，每槽 1 个 tick；第 1~3 层各 64 个槽，每层每槽覆盖下一层一整圈，
+  /// 总跨度 2^26 us（约 67 秒），更远的事件先放在最高层，降级时重新计算位置。
+  /// 推进时直接跳到下一个非空的 tick，tick 的粒度不影响开销；timerfd 按最早的到期时间用绝对时间设置。
+  /// 每个槽是 TimerEvent 的侵入式双向链表，插入和删除都是 O(1)。
+  /// 时间轮只在 loop 线程里访问，其他线程的 add/delete 通过 EventLoop 的无锁任务队列转到 loop 线程。
+  /// 同一个 TimerEvent 同一时间只能加到一个 EventLoop 上。
   class Timer : public FdEvent
   {
   public:
-    Timer();
+    Timer(EventLoop *event_loop);
 
     ~Timer();
 
+    // 任意线程调用
     void addTimerEvent(TimerEvent::s_ptr event);
 
+    // 任意线程调用，O(1) 从时间轮摘除
     void deleteTimerEvent(TimerEvent::s_ptr event);
 
     void onTimer(); // 当发送了 IO 事件后，eventloop 会执行这个回调函数
 
+    // 所属 EventLoop 的统计，用来记录定时任务的延迟
+    void setStats(EventLoopStats *stats);
+
   private:
     void resetArriveTime();
 
+    void insert(TimerEvent *event, bool is_cascade = false);
+
+    void unlink(TimerEvent *event);
+
+    // 把 tick 推进到 now，到期的事件放入 expired
+    void advance(int64_t now, std::vector<TimerEvent::s_ptr> &expired);
+
+    void cascade(int level, int64_t tick);
+
+    // 最早需要处理的 tick（事件到期或者高层槽位需要降级），没有事件返回 -1
+    int64_t nextTick();
+
   private:
-    std::multimap<int64_t, TimerEvent::s_ptr> m_pending_events;
-    Mutex m_mutex;
+    static const int LEVEL_COUNT = 4;
+    static const int LEVEL0_BITS = 8;
+    static const int LEVEL_BITS = 6;
+
+    std::vector<TimerEvent *> m_wheels[LEVEL_COUNT];
+
+    int64_t m_current_tick{0}; // 已经处理到的 tick
+    size_t m_event_count{0};
+    int64_t m_armed_tick{-1};  // timerfd 当前设置的到期 tick，-1 表示没有设置
+
+    EventLoopStats *m_stats{NULL};
+
+    EventLoop *m_event_loop{NULL};
   };
 
 }
 
-#endif
\ No newline at end of file
+#endif
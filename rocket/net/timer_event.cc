@@ -1,22 +1,44 @@
 
 #include "rocket/net/timer_event.h"
 #include "rocket/common/log.h"
-#include "rocket/common/util.h"
+#include "rocket/common/clock.h"
 
 namespace rocket
 {
 
   TimerEvent::TimerEvent(int interval, bool is_repeated, std::function<void()> cb)
-      : m_interval(interval), m_is_repeated(is_repeated), m_task(cb)
+      : m_interval((int64_t)interval * 1000), m_is_repeated(is_repeated), m_task(cb)
   {
     resetArriveTime();
   }
 
-  void TimerEvent::resetArriveTime()
+  TimerEvent::s_ptr TimerEvent::CreateByUs(int64_t interval_us, bool is_repeated, std::function<void()> cb)
   {
+    s_ptr event = std::make_shared<TimerEvent>(0, is_repeated, cb);
+    event->m_interval = interval_us;
+    event->resetArriveTime();
+    return event;
+  }
 
-    m_arrive_time = getNowMs() + m_interval;
+  void TimerEvent::resetArriveTime()
+  {
+    // 用本线程 loop 缓存的时间，同一轮 loop 里创建的定时器不再重复读时钟
+    m_arrive_time = Clock::CachedUs() + m_interval;
     // DEBUGLOG("success create timer event, will excute at [%lld]", m_arrive_time);
   }
 
+  void TimerEvent::advanceArriveTime(int64_t now_us)
+  {
+    if (m_interval <= 0)
+    {
+      m_arrive_time = now_us;
+      return;
+    }
+    m_arrive_time += m_interval;
+    if (m_arrive_time <= now_us)
+    {
+      m_arrive_time += ((now_us - m_arrive_time) / m_interval + 1) * m_interval;
+    }
+  }
+
 }
\ No newline at end of file
@@ -3,19 +3,35 @@
 
 #include <functional>
 #include <memory>
+#include <atomic>
+#include "rocket/net/task_priority.h"
 
 namespace rocket
 {
 
+  class Timer;
+
   class TimerEvent
   {
+    friend class Timer;
 
   public:
     typedef std::shared_ptr<TimerEvent> s_ptr;
 
+    // interval 单位 ms
     TimerEvent(int interval, bool is_repeated, std::function<void()> cb);
 
+    // 微秒精度的定时任务
+    static s_ptr CreateByUs(int64_t interval_us, bool is_repeated, std::function<void()> cb);
+
+    // 到期时间，单调时钟，ms
     int64_t getArriveTime() const
+    {
+      return m_arrive_time / 1000;
+    }
+
+    // 到期时间，单调时钟，us
+    int64_t getArriveTimeUs() const
     {
       return m_arrive_time;
     }
@@ -40,17 +56,40 @@ namespace rocket
       return m_task;
     }
 
+    // 从当前时间重新开始计时
     void resetArriveTime();
 
+    // 重复任务的下一次到期时间：从上一次的到期时间往后推整数个周期，跳过已经错过的周期，不会累积漂移
+    void advanceArriveTime(int64_t now_us);
+
+    // 到期后回调放入 EventLoop 哪个优先级的任务队列执行
+    void setPriority(TaskPriority priority)
+    {
+      m_priority = priority;
+    }
+
+    TaskPriority getPriority()
+    {
+      return m_priority;
+    }
+
   private:
-    int64_t m_arrive_time; // ms
-    int64_t m_interval;    // ms
+    int64_t m_arrive_time; // us, 单调时钟
+    int64_t m_interval;    // us
     bool m_is_repeated{false};
-    bool m_is_cancled{false};
+    std::atomic<bool> m_is_cancled{false};
+    TaskPriority m_priority{TaskPriorityTimer};
 
     std::function<void()> m_task;
+
+    // 以下由 Timer 在 loop 线程里维护：时间轮槽位的侵入式双向链表
+    TimerEvent *m_prev{NULL};
+    TimerEvent *m_next{NULL};
+    TimerEvent **m_slot{NULL}; // 所在槽位的链表头，不在时间轮里时为 NULL
+    s_ptr m_self;              // 在时间轮里时持有自己，保证 Timer 里的裸指针有效
+    std::atomic<Timer *> m_owner{NULL}; // 挂在哪个 Timer 上，同一时间只能属于一个 EventLoop
   };
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,240 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "rocket/common/crc32c.h"
+#include "rocket/common/byte_scan.h"
+
+// crc32c 各个实现和 PB_START 扫描的正确性检查与基准测试
+// 用法：test_crc32c [轮数倍率]
+
+static const char PB_START = 0x02;
+static const char PB_START_V2 = 0x04;
+
+static double nowSec()
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// decode 里原来的逐字节扫描
+static const char *scalarFind(const char *begin, const char *end, char a, char b)
+{
+  const char *p = begin;
+  while (p < end && *p != a && *p != b)
+  {
+    ++p;
+  }
+  return p;
+}
+
+// byte_scan.cc 在非 x86 平台上的实现，先找 a，再只在 a 之前找 b
+static const char *memchrFind(const char *begin, const char *end, char a, char b)
+{
+  const char *pa = static_cast<const char *>(memchr(begin, a, end - begin));
+  if (pa == NULL)
+  {
+    pa = end;
+  }
+  const char *pb = static_cast<const char *>(memchr(begin, b, pa - begin));
+  return pb ? pb : pa;
+}
+
+static bool checkCrc(const std::vector<rocket::Crc32cImpl> &impls)
+{
+  if (rocket::crc32c("123456789", 9) != 0xe3069283)
+  {
+    printf("crc32c(\"123456789\") = %08x, expect e3069283\n", rocket::crc32c("123456789", 9));
+    return false;
+  }
+
+  std::string data(3 * 4096 + 77, 0);
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    data[i] = (char)(rand() & 0xff);
+  }
+
+  // 不同长度、不同对齐都和逐字节查表的结果一致
+  for (size_t len = 0; len + 7 <= data.size(); len = len < 64 ? len + 1 : len * 3 / 2 + 1)
+  {
+    for (size_t offset = 0; offset < 8; ++offset)
+    {
+      uint32_t expect = ~impls[0].m_func(~0u, data.data() + offset, len);
+      for (size_t i = 1; i < impls.size(); ++i)
+      {
+        uint32_t crc = ~impls[i].m_func(~0u, data.data() + offset, len);
+        if (crc != expect)
+        {
+          printf("%s mismatch, len %zu, offset %zu: %08x != %08x\n", impls[i].m_name, len, offset, crc, expect);
+          return false;
+        }
+      }
+    }
+  }
+
+  // 分段计算和一次算完一致
+  uint32_t whole = rocket::crc32c(data.data(), data.size());
+  for (size_t split = 0; split <= data.size(); split += 331)
+  {
+    uint32_t crc = rocket::crc32cExtend(rocket::crc32c(data.data(), split), data.data() + split, data.size() - split);
+    if (crc != whole)
+    {
+      printf("crc32cExtend mismatch at split %zu\n", split);
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool checkScan()
+{
+  // 起始地址也要变，覆盖向量实现里对齐之前和末尾重叠读的每一种情况
+  std::string data(1000, 'x');
+  for (size_t len = 0; len < 320; ++len)
+  {
+    for (size_t pos = 0; pos <= len; ++pos)
+    {
+      for (int k = 0; k < 2; ++k)
+      {
+        size_t shift = (len + pos) % 64;
+        std::string buf = data.substr(0, shift + len);
+        if (pos < len)
+        {
+          buf[shift + pos] = k ? PB_START_V2 : PB_START;
+        }
+        const char *begin = buf.data() + shift;
+        const char *end = begin + len;
+        if (rocket::findFirstOf2(begin, end, PB_START, PB_START_V2) != scalarFind(begin, end, PB_START, PB_START_V2))
+        {
+          printf("findFirstOf2 mismatch, len %zu, pos %zu, shift %zu\n", len, pos, shift);
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+static void benchCrc(const std::vector<rocket::Crc32cImpl> &impls, int scale)
+{
+  size_t sizes[] = {64, 1024, 64 * 1024, 1024 * 1024};
+  std::string data(sizes[3], 0);
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    data[i] = (char)(rand() & 0xff);
+  }
+
+  printf("\ncrc32c, MB/s\n%10s", "size");
+  for (size_t i = 0; i < impls.size(); ++i)
+  {
+    printf("%12s", impls[i].m_name);
+  }
+  printf("\n");
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+  {
+    size_t size = sizes[s];
+    size_t rounds = (size_t)scale * 64 * 1024 * 1024 / size;
+    printf("%10zu", size);
+    for (size_t i = 0; i < impls.size(); ++i)
+    {
+      // 逐字节查表太慢，少跑一些
+      size_t n = i == 0 ? rounds / 8 + 1 : rounds;
+      uint32_t crc = 0;
+      double start = nowSec();
+      for (size_t r = 0; r < n; ++r)
+      {
+        crc = impls[i].m_func(crc, data.data(), size);
+      }
+      double cost = nowSec() - start;
+      printf("%12.0f", (double)size * n / cost / 1e6);
+      if (crc == 0x12345678)
+      {
+        printf("!");
+      }
+    }
+    printf("\n");
+  }
+}
+
+static void benchScan(int scale)
+{
+  // 只有最后一个字节是开始符，相当于一长段垃圾数据之后重新同步
+  size_t sizes[] = {64, 1024, 64 * 1024};
+  std::string data(sizes[2], 'x');
+
+  printf("\nPB_START scan, MB/s\n%10s%12s%12s%12s%12s\n", "size", "scalar", "simd", "memchr x2", "memchr");
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+  {
+    size_t size = sizes[s];
+    std::string buf = data.substr(0, size);
+    buf[size - 1] = PB_START;
+    const char *begin = buf.data();
+    const char *end = begin + size;
+    size_t rounds = (size_t)scale * 256 * 1024 * 1024 / size;
+    size_t found = 0;
+
+    printf("%10zu", size);
+    double start = nowSec();
+    for (size_t r = 0; r < rounds / 8 + 1; ++r)
+    {
+      found += scalarFind(begin, end, PB_START, PB_START_V2) - begin;
+    }
+    printf("%12.0f", (double)size * (rounds / 8 + 1) / (nowSec() - start) / 1e6);
+
+    start = nowSec();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+      found += rocket::findFirstOf2(begin, end, PB_START, PB_START_V2) - begin;
+    }
+    printf("%12.0f", (double)size * rounds / (nowSec() - start) / 1e6);
+
+    // 非 x86 平台的实现：两次 libc memchr，同样通过 volatile 指针调用
+    const char *(*volatile memchr_find)(const char *, const char *, char, char) = memchrFind;
+    start = nowSec();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+      found += memchr_find(begin, end, PB_START, PB_START_V2) - begin;
+    }
+    printf("%12.0f", (double)size * rounds / (nowSec() - start) / 1e6);
+
+    // 只找一个字节，作为参考上限。通过 volatile 指针调用，避免编译器把 memchr 提到循环外
+    const void *(*volatile memchr_func)(const void *, int, size_t) = memchr;
+    start = nowSec();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+      found += static_cast<const char *>(memchr_func(begin, PB_START, size)) - begin;
+    }
+    printf("%12.0f", (double)size * rounds / (nowSec() - start) / 1e6);
+    printf(found == 0 ? "!\n" : "\n");
+  }
+}
+
+int main(int argc, char **argv)
+{
+  int scale = argc > 1 ? atoi(argv[1]) : 1;
+  if (scale <= 0)
+  {
+    scale = 1;
+  }
+
+  std::vector<rocket::Crc32cImpl> impls = rocket::getCrc32cImpls();
+  printf("crc32c impls:");
+  for (size_t i = 0; i < impls.size(); ++i)
+  {
+    printf(" %s", impls[i].m_name);
+  }
+  printf(", use %s\n", impls.back().m_name);
+
+  if (!checkCrc(impls) || !checkScan())
+  {
+    printf("check failed\n");
+    return 1;
+  }
+  printf("check ok\n");
+
+  benchCrc(impls, scale);
+  benchScan(scale);
+  return 0;
+}
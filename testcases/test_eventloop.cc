@@ -55,7 +55,10 @@ void test_io_thread()
   int i = 0;
   rocket::TimerEvent::s_ptr timer_event = std::make_shared<rocket::TimerEvent>(
       1000, true, [&i]()
-      { INFOLOG("trigger timer event, count=%d", i++); });
+      {
+        INFOLOG("trigger timer event, count=%d", i++);
+        INFOLOG("event loop stats: %s", rocket::EventLoop::GetCurrentEventLoop()->getStats().toString().c_str());
+      });
 
   // rocket::IOThread io_thread;
 
@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <set>
+#include <string>
+#include <memory>
+#include "rocket/common/log.h"
+#include "rocket/common/config.h"
+#include "rocket/net/tcp/tcp_server.h"
+#include "rocket/net/tcp/tcp_client.h"
+#include "rocket/net/tcp/tcp_buffer.h"
+#include "rocket/net/tcp/net_addr.h"
+#include "rocket/net/coder/tinypb_coder.h"
+#include "rocket/net/coder/tinypb_protocol.h"
+#include "rocket/net/rpc/rpc_dispatcher.h"
+#include "rocket/net/timer_event.h"
+
+#include "order.pb.h"
+
+// 心跳测试：进程内起一个 heartbeat_interval < idle_timeout 的服务端
+// 1. 同一批数据里先 ping 再请求，pong 和响应都要收到
+// 2. 客户端连上后一直空闲，超过 idle_timeout 之后连接仍然可用（客户端会回服务端的 ping）
+// 用法：./test_heartbeat ../conf/rocket.xml
+
+static const int TEST_PORT = 12346;
+static const int IDLE_TIMEOUT_MS = 1000;
+static const int HEARTBEAT_INTERVAL_MS = 200;
+
+class OrderImpl : public Order
+{
+public:
+  void makeOrder(google::protobuf::RpcController *controller,
+                 const ::makeOrderRequest *request,
+                 ::makeOrderResponse *response,
+                 ::google::protobuf::Closure *done)
+  {
+    response->set_order_id("20230514");
+    if (done)
+    {
+      done->Run();
+      delete done;
+      done = NULL;
+    }
+  }
+};
+
+static void *runServer(void *)
+{
+  rocket::IPNetAddr::s_ptr addr = std::make_shared<rocket::IPNetAddr>("127.0.0.1", TEST_PORT);
+  rocket::TcpServer tcp_server(addr);
+  tcp_server.start();
+  return NULL;
+}
+
+static std::shared_ptr<rocket::TinyPBProtocol> makeRequest(const std::string &msg_id)
+{
+  makeOrderRequest request;
+  request.set_price(100);
+  request.set_goods("apple");
+
+  std::shared_ptr<rocket::TinyPBProtocol> message = std::make_shared<rocket::TinyPBProtocol>();
+  message->m_msg_id = msg_id;
+  message->m_method_name = "Order.makeOrder";
+  request.SerializeToString(&(message->m_pb_data));
+  return message;
+}
+
+// ping 和请求在一次 write 里发出去，服务端一次读到，pong 和响应都要回来
+static bool testPingWithRequest()
+{
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in server_addr;
+  memset(&server_addr, 0, sizeof(server_addr));
+  server_addr.sin_family = AF_INET;
+  server_addr.sin_port = htons(TEST_PORT);
+  inet_aton("127.0.0.1", &server_addr.sin_addr);
+  if (connect(fd, reinterpret_cast<sockaddr *>(&server_addr), sizeof(server_addr)) != 0)
+  {
+    printf("connect error, errno=%d\n", errno);
+    close(fd);
+    return false;
+  }
+  timeval timeout = {2, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  rocket::TinyPBCoder coder;
+  std::vector<rocket::AbstractProtocol::s_ptr> messages;
+  messages.push_back(rocket::TinyPBProtocol::CreateHeartbeat(true));
+  messages.push_back(makeRequest("1001"));
+  rocket::TcpBuffer::s_ptr out = std::make_shared<rocket::TcpBuffer>(128);
+  coder.encode(messages, out);
+  if (write(fd, out->readPtr(), out->readAble()) != out->readAble())
+  {
+    printf("write error, errno=%d\n", errno);
+    close(fd);
+    return false;
+  }
+
+  std::set<std::string> msg_ids;
+  rocket::TcpBuffer::s_ptr in = std::make_shared<rocket::TcpBuffer>(128);
+  while (msg_ids.size() < 2)
+  {
+    bool is_full = false;
+    if (in->readFromFd(fd, is_full) <= 0)
+    {
+      break;
+    }
+    std::vector<rocket::AbstractProtocol::s_ptr> result;
+    coder.decode(result, in);
+    for (size_t i = 0; i < result.size(); ++i)
+    {
+      msg_ids.insert(result[i]->m_msg_id);
+    }
+  }
+  close(fd);
+
+  if (!msg_ids.count(rocket::TinyPBProtocol::HEARTBEAT_PONG) || !msg_ids.count("1001"))
+  {
+    printf("testPingWithRequest failed, got %zu frames\n", msg_ids.size());
+    return false;
+  }
+  printf("testPingWithRequest ok\n");
+  return true;
+}
+
+// 连上之后空闲 3 个 idle_timeout，再发请求，连接还在就能收到响应
+static bool testIdleClient()
+{
+  rocket::IPNetAddr::s_ptr addr = std::make_shared<rocket::IPNetAddr>("127.0.0.1", TEST_PORT);
+  rocket::TcpClient client(addr);
+  bool success = false;
+
+  client.connect([&client, &success]()
+                 {
+    rocket::TimerEvent::s_ptr request_timer = std::make_shared<rocket::TimerEvent>(IDLE_TIMEOUT_MS * 3, false, [&client, &success]() {
+      client.writeMessage(makeRequest("2002"), [](rocket::AbstractProtocol::s_ptr) {});
+      client.readMessage("2002", [&client, &success](rocket::AbstractProtocol::s_ptr msg) {
+        std::shared_ptr<rocket::TinyPBProtocol> response = std::dynamic_pointer_cast<rocket::TinyPBProtocol>(msg);
+        makeOrderResponse order;
+        success = response && order.ParseFromArray(response->pbData(), response->pbDataLength()) && order.order_id() == "20230514";
+        client.stop();
+      });
+    });
+    client.addTimerEvent(request_timer);
+
+    // 连接被服务端关掉时收不到响应，到时间直接结束
+    rocket::TimerEvent::s_ptr fail_timer = std::make_shared<rocket::TimerEvent>(IDLE_TIMEOUT_MS * 5, false, [&client]() {
+      client.stop();
+    });
+    client.addTimerEvent(fail_timer); });
+
+  printf(success ? "testIdleClient ok\n" : "testIdleClient failed, connection closed while idle\n");
+  return success;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc != 2)
+  {
+    printf("Start test_heartbeat error, argc not 2 \n");
+    printf("Start like this: \n");
+    printf("./test_heartbeat ../conf/rocket.xml \n");
+    return 0;
+  }
+
+  rocket::Config::SetGlobalConfig(argv[1]);
+  rocket::Config::GetGlobalConfig()->m_port = TEST_PORT;
+  rocket::Config::GetGlobalConfig()->m_idle_timeout_ms = IDLE_TIMEOUT_MS;
+  rocket::Config::GetGlobalConfig()->m_heartbeat_interval_ms = HEARTBEAT_INTERVAL_MS;
+
+  rocket::Logger::InitGlobalLogger(0);
+
+  std::shared_ptr<OrderImpl> service = std::make_shared<OrderImpl>();
+  rocket::RpcDispatcher::GetRpcDispatcher()->registerService(service);
+
+  pthread_t server_thread;
+  pthread_create(&server_thread, NULL, &runServer, NULL);
+  sleep(1);
+
+  bool ok = testPingWithRequest() && testIdleClient();
+  printf(ok ? "test_heartbeat ok\n" : "test_heartbeat failed\n");
+  fflush(stdout);
+
+  // 服务端线程一直在跑 loop，不走全局析构直接退出
+  _exit(ok ? 0 : 1);
+}
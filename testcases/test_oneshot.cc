@@ -0,0 +1,179 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
+#include <memory>
+#include "rocket/common/log.h"
+#include "rocket/common/config.h"
+#include "rocket/net/tcp/tcp_server.h"
+#include "rocket/net/tcp/tcp_buffer.h"
+#include "rocket/net/tcp/net_addr.h"
+#include "rocket/net/coder/tinypb_coder.h"
+#include "rocket/net/coder/tinypb_protocol.h"
+#include "rocket/net/rpc/rpc_dispatcher.h"
+
+#include "order.pb.h"
+
+// EPOLLONESHOT 测试：服务端把请求交给 worker 线程，worker 回包之前这个连接不会再触发 onRead
+// 客户端先发一个请求，等它到了 worker 之后再发第二个，第二个请求只能在第一个回包之后才被分发
+// 用法：./test_oneshot ../conf/rocket.xml
+
+static const int TEST_PORT = 12347;
+static const int WORKER_DELAY_MS = 300;
+
+static std::atomic<int> g_outstanding(0); // 已经交给 worker、还没回包的请求数
+static std::atomic<bool> g_overlapped(false); // 有请求在别的请求回包之前被分发了
+static std::atomic<int> g_dispatched(0);
+
+class OrderImpl : public Order
+{
+public:
+  void makeOrder(google::protobuf::RpcController *controller,
+                 const ::makeOrderRequest *request,
+                 ::makeOrderResponse *response,
+                 ::google::protobuf::Closure *done)
+  {
+    if (g_outstanding.fetch_add(1) > 0)
+    {
+      g_overlapped = true;
+    }
+    ++g_dispatched;
+
+    std::string goods = request->goods();
+    std::thread worker([response, done, goods]()
+                       {
+      usleep(WORKER_DELAY_MS * 1000);
+      response->set_order_id(goods);
+      // 回包投递到 IO 线程写出去之后才会读下一个请求，先减掉再回包
+      --g_outstanding;
+      done->Run();
+      delete done; });
+    worker.detach();
+  }
+};
+
+static void *runServer(void *)
+{
+  rocket::IPNetAddr::s_ptr addr = std::make_shared<rocket::IPNetAddr>("127.0.0.1", TEST_PORT);
+  rocket::TcpServer tcp_server(addr);
+  tcp_server.start();
+  return NULL;
+}
+
+static bool sendRequest(int fd, rocket::TinyPBCoder &coder, const std::string &msg_id)
+{
+  makeOrderRequest request;
+  request.set_price(100);
+  request.set_goods(msg_id);
+
+  std::shared_ptr<rocket::TinyPBProtocol> message = std::make_shared<rocket::TinyPBProtocol>();
+  message->m_msg_id = msg_id;
+  message->m_method_name = "Order.makeOrder";
+  request.SerializeToString(&(message->m_pb_data));
+
+  std::vector<rocket::AbstractProtocol::s_ptr> messages;
+  messages.push_back(message);
+  rocket::TcpBuffer::s_ptr out = std::make_shared<rocket::TcpBuffer>(128);
+  coder.encode(messages, out);
+  return write(fd, out->readPtr(), out->readAble()) == out->readAble();
+}
+
+static bool testHandOff()
+{
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in server_addr;
+  memset(&server_addr, 0, sizeof(server_addr));
+  server_addr.sin_family = AF_INET;
+  server_addr.sin_port = htons(TEST_PORT);
+  inet_aton("127.0.0.1", &server_addr.sin_addr);
+  if (connect(fd, reinterpret_cast<sockaddr *>(&server_addr), sizeof(server_addr)) != 0)
+  {
+    printf("connect error, errno=%d\n", errno);
+    close(fd);
+    return false;
+  }
+  timeval timeout = {WORKER_DELAY_MS * 4 / 1000 + 1, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  // 第二个请求单独发，保证服务端在第一个请求交给 worker 之后才收到它
+  rocket::TinyPBCoder coder;
+  bool ok = sendRequest(fd, coder, "3001");
+  usleep(WORKER_DELAY_MS * 1000 / 3);
+  ok = ok && g_dispatched == 1 && sendRequest(fd, coder, "3002");
+
+  std::vector<std::string> order_ids;
+  rocket::TcpBuffer::s_ptr in = std::make_shared<rocket::TcpBuffer>(128);
+  while (ok && order_ids.size() < 2)
+  {
+    bool is_full = false;
+    if (in->readFromFd(fd, is_full) <= 0)
+    {
+      break;
+    }
+    std::vector<rocket::AbstractProtocol::s_ptr> result;
+    coder.decode(result, in);
+    for (size_t i = 0; i < result.size(); ++i)
+    {
+      std::shared_ptr<rocket::TinyPBProtocol> response = std::dynamic_pointer_cast<rocket::TinyPBProtocol>(result[i]);
+      makeOrderResponse order;
+      if (response && order.ParseFromArray(response->pbData(), response->pbDataLength()))
+      {
+        order_ids.push_back(order.order_id());
+      }
+    }
+  }
+  close(fd);
+
+  if (order_ids.size() != 2 || order_ids[0] != "3001" || order_ids[1] != "3002")
+  {
+    printf("testHandOff failed, got %zu responses\n", order_ids.size());
+    return false;
+  }
+  if (g_overlapped)
+  {
+    printf("testHandOff failed, second request dispatched while the first one was still in the worker\n");
+    return false;
+  }
+  printf("testHandOff ok\n");
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc != 2)
+  {
+    printf("Start test_oneshot error, argc not 2 \n");
+    printf("Start like this: \n");
+    printf("./test_oneshot ../conf/rocket.xml \n");
+    return 0;
+  }
+
+  rocket::Config::SetGlobalConfig(argv[1]);
+  rocket::Config::GetGlobalConfig()->m_port = TEST_PORT;
+  rocket::Config::GetGlobalConfig()->m_one_shot = true;
+
+  rocket::Logger::InitGlobalLogger(0);
+
+  std::shared_ptr<OrderImpl> service = std::make_shared<OrderImpl>();
+  rocket::RpcDispatcher::GetRpcDispatcher()->registerService(service);
+
+  pthread_t server_thread;
+  pthread_create(&server_thread, NULL, &runServer, NULL);
+  sleep(1);
+
+  bool ok = testHandOff();
+  printf(ok ? "test_oneshot ok\n" : "test_oneshot failed\n");
+  fflush(stdout);
+
+  // 服务端线程一直在跑 loop，不走全局析构直接退出
+  _exit(ok ? 0 : 1);
+}
@@ -0,0 +1,375 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <arpa/inet.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include "rocket/common/log.h"
+#include "rocket/common/config.h"
+#include "rocket/common/crc32c.h"
+#include "rocket/common/msg_id_util.h"
+#include "rocket/net/tcp/tcp_buffer.h"
+#include "rocket/net/coder/tinypb_coder.h"
+#include "rocket/net/coder/tinypb_protocol.h"
+
+// TinyPB 编解码测试：一个 coder 编码、另一个 coder 解码，模拟连接的两端
+// 覆盖 v1/v2 往返、v2 协商、zigzag 错误码、CRC 校验失败、未知方法号、字符串 msg_id、GenMsgID 走 8 字节 msg_id、大包的预留空间
+// 用法：./test_tinypb_coder ../conf/rocket.xml
+
+#define CHECK(cond)                                              \
+  if (!(cond))                                                   \
+  {                                                              \
+    printf("%s:%d check failed: %s\n", __FILE__, __LINE__, #cond); \
+    return false;                                                \
+  }
+
+static const char *KNOWN_METHOD = "Codec.known";
+
+static std::shared_ptr<rocket::TinyPBProtocol> makeMessage(const std::string &msg_id, const std::string &method_name, const std::string &pb_data)
+{
+  std::shared_ptr<rocket::TinyPBProtocol> message = std::make_shared<rocket::TinyPBProtocol>();
+  message->m_msg_id = msg_id;
+  message->m_method_name = method_name;
+  message->m_pb_data = pb_data;
+  return message;
+}
+
+// 按配置里的 tinypb_v2 创建 coder，模拟打开或关闭 v2 的对端
+static std::shared_ptr<rocket::TinyPBCoder> makeCoder(bool enable_v2)
+{
+  rocket::Config::GetGlobalConfig()->m_tinypb_v2 = enable_v2;
+  return std::make_shared<rocket::TinyPBCoder>();
+}
+
+static void encodeMessage(rocket::TinyPBCoder &coder, std::shared_ptr<rocket::TinyPBProtocol> message, rocket::TcpBuffer::s_ptr out)
+{
+  std::vector<rocket::AbstractProtocol::s_ptr> messages;
+  messages.push_back(message);
+  coder.encode(messages, out);
+}
+
+// 解码 buffer 里的所有帧，pb_data 拷出来，之后可以随意修改 buffer
+static std::vector<std::shared_ptr<rocket::TinyPBProtocol>> decodeAll(rocket::TinyPBCoder &coder, rocket::TcpBuffer::s_ptr in)
+{
+  std::vector<rocket::AbstractProtocol::s_ptr> messages;
+  coder.decode(messages, in);
+  std::vector<std::shared_ptr<rocket::TinyPBProtocol>> result;
+  for (size_t i = 0; i < messages.size(); ++i)
+  {
+    std::shared_ptr<rocket::TinyPBProtocol> message = std::dynamic_pointer_cast<rocket::TinyPBProtocol>(messages[i]);
+    message->detach();
+    result.push_back(message);
+  }
+  return result;
+}
+
+// from 编码一帧交给 to 解码，frame 里留下编码后的原始字节
+static std::shared_ptr<rocket::TinyPBProtocol> transfer(rocket::TinyPBCoder &from, rocket::TinyPBCoder &to,
+                                                        std::shared_ptr<rocket::TinyPBProtocol> message, std::string &frame)
+{
+  rocket::TcpBuffer::s_ptr buffer = std::make_shared<rocket::TcpBuffer>(128);
+  encodeMessage(from, message, buffer);
+  frame.assign(buffer->readPtr(), buffer->readAble());
+  std::vector<std::shared_ptr<rocket::TinyPBProtocol>> result = decodeAll(to, buffer);
+  if (result.size() != 1 || buffer->readAble() != 0)
+  {
+    return NULL;
+  }
+  return result[0];
+}
+
+static bool sameMessage(std::shared_ptr<rocket::TinyPBProtocol> a, std::shared_ptr<rocket::TinyPBProtocol> b)
+{
+  return a->m_msg_id == b->m_msg_id && a->m_method_name == b->m_method_name && a->m_err_code == b->m_err_code &&
+         a->m_err_info == b->m_err_info && a->m_pb_data == b->m_pb_data;
+}
+
+// v2 帧里 flags 紧跟在开始符和包长之后
+static uint8_t frameFlags(const std::string &frame)
+{
+  return (uint8_t)frame[1 + 4];
+}
+
+// 校验和在结束符之前的 4 个字节
+static int32_t frameCheckSum(const std::string &frame)
+{
+  uint32_t check_sum_net = 0;
+  memcpy(&check_sum_net, &frame[frame.length() - 5], sizeof(check_sum_net));
+  return (int32_t)ntohl(check_sum_net);
+}
+
+// 改过 v2 帧的内容之后重新计算校验和
+static void resealFrameV2(std::string &frame)
+{
+  uint32_t crc = htonl(rocket::crc32c(frame.data(), frame.length() - 5));
+  memcpy(&frame[frame.length() - 5], &crc, sizeof(crc));
+}
+
+static rocket::TcpBuffer::s_ptr bufferOf(const std::string &frame)
+{
+  rocket::TcpBuffer::s_ptr buffer = std::make_shared<rocket::TcpBuffer>(128);
+  buffer->writeToBuffer(frame.data(), frame.length());
+  return buffer;
+}
+
+// 两端都打开 v2：第一帧是校验和声明了 v2 的 v1，对端收到后回 v2，之后双方都发 v2；err_info 始终为空
+static bool testNegotiate()
+{
+  std::shared_ptr<rocket::TinyPBCoder> client = makeCoder(true);
+  std::shared_ptr<rocket::TinyPBCoder> server = makeCoder(true);
+  std::string frame;
+
+  std::shared_ptr<rocket::TinyPBProtocol> request = makeMessage("1", KNOWN_METHOD, "req");
+  std::shared_ptr<rocket::TinyPBProtocol> decoded = transfer(*client, *server, request, frame);
+  CHECK(decoded);
+  CHECK(frame[0] == rocket::TinyPBProtocol::PB_START);
+  CHECK(frameCheckSum(frame) == rocket::TinyPBProtocol::V2_NEGOTIATE_CHECK_SUM);
+  CHECK(decoded->m_version == 1 && decoded->m_err_info.empty() && decoded->m_err_info_len == 0);
+  CHECK(sameMessage(request, decoded));
+
+  std::shared_ptr<rocket::TinyPBProtocol> response = makeMessage("1", KNOWN_METHOD, "resp");
+  decoded = transfer(*server, *client, response, frame);
+  CHECK(decoded);
+  CHECK(frame[0] == rocket::TinyPBProtocol::PB_START_V2 && decoded->m_version == 2);
+  CHECK(sameMessage(response, decoded));
+
+  request = makeMessage("2", KNOWN_METHOD, "req");
+  decoded = transfer(*client, *server, request, frame);
+  CHECK(decoded);
+  CHECK(frame[0] == rocket::TinyPBProtocol::PB_START_V2);
+  CHECK(sameMessage(request, decoded));
+
+  printf("testNegotiate ok\n");
+  return true;
+}
+
+// 对端关闭 v2：它不理会校验和，双方一直用 v1，字段原样往返，它发的 v1 帧校验和还是 1
+static bool testV1Peer()
+{
+  std::shared_ptr<rocket::TinyPBCoder> client = makeCoder(true);
+  std::shared_ptr<rocket::TinyPBCoder> server = makeCoder(false);
+  std::string frame;
+
+  std::shared_ptr<rocket::TinyPBProtocol> request = makeMessage("abc-01", KNOWN_METHOD, std::string("a\0b", 3));
+  std::shared_ptr<rocket::TinyPBProtocol> decoded = transfer(*client, *server, request, frame);
+  CHECK(decoded);
+  CHECK(decoded->m_err_info.empty() && decoded->m_err_info_len == 0);
+  CHECK(sameMessage(request, decoded));
+
+  for (int i = 0; i < 2; ++i)
+  {
+    std::shared_ptr<rocket::TinyPBProtocol> response = makeMessage("abc-01", KNOWN_METHOD, "resp");
+    response->m_err_code = -3;
+    response->m_err_info = "failed";
+    decoded = transfer(*server, *client, response, frame);
+    CHECK(decoded);
+    CHECK(frame[0] == rocket::TinyPBProtocol::PB_START && decoded->m_version == 1);
+    CHECK(frameCheckSum(frame) == 1);
+    CHECK(sameMessage(response, decoded));
+
+    request = makeMessage("abc-02", KNOWN_METHOD, "req");
+    decoded = transfer(*client, *server, request, frame);
+    CHECK(decoded);
+    CHECK(frame[0] == rocket::TinyPBProtocol::PB_START);
+    CHECK(sameMessage(request, decoded));
+  }
+
+  printf("testV1Peer ok\n");
+  return true;
+}
+
+// 建好一对已经协商到 v2 的 coder
+static bool makeV2Pair(std::shared_ptr<rocket::TinyPBCoder> &client, std::shared_ptr<rocket::TinyPBCoder> &server)
+{
+  client = makeCoder(true);
+  server = makeCoder(true);
+  std::string frame;
+  CHECK(transfer(*client, *server, makeMessage("1", KNOWN_METHOD, ""), frame));
+  CHECK(transfer(*server, *client, makeMessage("1", KNOWN_METHOD, ""), frame));
+  CHECK(frame[0] == rocket::TinyPBProtocol::PB_START_V2);
+  return true;
+}
+
+// v2 各种字段组合：数字和字符串 msg_id、方法号和方法名、zigzag 错误码
+static bool testV2Fields()
+{
+  std::shared_ptr<rocket::TinyPBCoder> client, server;
+  CHECK(makeV2Pair(client, server));
+  std::string frame;
+
+  // 数字 msg_id 和注册过的方法走 8 字节 msg_id、4 字节方法号
+  std::shared_ptr<rocket::TinyPBProtocol> message = makeMessage("9223372036854775807", KNOWN_METHOD, "data");
+  std::shared_ptr<rocket::TinyPBProtocol> decoded = transfer(*client, *server, message, frame);
+  CHECK(decoded);
+  CHECK(frameFlags(frame) == 0);
+  CHECK(frame.length() == 1 + 4 + 1 + 8 + 4 + 4 + 4 + 1);
+  CHECK(sameMessage(message, decoded));
+
+  // 不能无损转成整数的 msg_id 和没注册的方法按字符串发送
+  const char *string_ids[] = {"abc-01", "007", "12345678901234567890", ""};
+  for (size_t i = 0; i < sizeof(string_ids) / sizeof(string_ids[0]); ++i)
+  {
+    message = makeMessage(string_ids[i], "Codec.unregistered", "data");
+    decoded = transfer(*client, *server, message, frame);
+    CHECK(decoded);
+    if (string_ids[i][0] == '\0')
+    {
+      // 空 msg_id 编码时会填上默认值
+      CHECK(message->m_msg_id == "123456789" && frameFlags(frame) == rocket::TinyPBProtocol::FLAG_METHOD_NAME);
+    }
+    else
+    {
+      CHECK(frameFlags(frame) == (rocket::TinyPBProtocol::FLAG_STRING_MSG_ID | rocket::TinyPBProtocol::FLAG_METHOD_NAME));
+    }
+    CHECK(sameMessage(message, decoded));
+  }
+
+  // 错误码按 zigzag 编码，负数和边界值都能还原
+  int32_t err_codes[] = {-1, 1, -64, 64, INT32_MAX, INT32_MIN};
+  for (size_t i = 0; i < sizeof(err_codes) / sizeof(err_codes[0]); ++i)
+  {
+    message = makeMessage("42", KNOWN_METHOD, "");
+    message->m_err_code = err_codes[i];
+    message->m_err_info = "error " + std::to_string(err_codes[i]);
+    decoded = transfer(*server, *client, message, frame);
+    CHECK(decoded);
+    CHECK(frameFlags(frame) == rocket::TinyPBProtocol::FLAG_ERROR);
+    CHECK(sameMessage(message, decoded));
+  }
+  // 只有 err_info 也要带上
+  message = makeMessage("43", KNOWN_METHOD, "");
+  message->m_err_info = "warning";
+  decoded = transfer(*server, *client, message, frame);
+  CHECK(decoded);
+  CHECK(frameFlags(frame) == rocket::TinyPBProtocol::FLAG_ERROR);
+  CHECK(sameMessage(message, decoded));
+
+  printf("testV2Fields ok\n");
+  return true;
+}
+
+// 默认配置下 RPC 用的 GenMsgID 生成的 msg_id 走 8 字节整数，而不是字符串
+static bool testGenMsgId()
+{
+  std::shared_ptr<rocket::TinyPBCoder> client, server;
+  CHECK(makeV2Pair(client, server));
+  std::string frame;
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    std::shared_ptr<rocket::TinyPBProtocol> message = makeMessage(rocket::MsgIDUtil::GenMsgID(), KNOWN_METHOD, "data");
+    std::shared_ptr<rocket::TinyPBProtocol> decoded = transfer(*client, *server, message, frame);
+    CHECK(decoded);
+    CHECK((frameFlags(frame) & rocket::TinyPBProtocol::FLAG_STRING_MSG_ID) == 0);
+    CHECK(sameMessage(message, decoded));
+  }
+
+  printf("testGenMsgId ok\n");
+  return true;
+}
+
+// 改动任何一个字节 CRC 都对不上，这一帧被丢掉，后面的帧照常解码
+static bool testBadCrc()
+{
+  std::shared_ptr<rocket::TinyPBCoder> client, server;
+  CHECK(makeV2Pair(client, server));
+
+  rocket::TcpBuffer::s_ptr buffer = std::make_shared<rocket::TcpBuffer>(128);
+  encodeMessage(*client, makeMessage("100", KNOWN_METHOD, "payload"), buffer);
+  std::string frame(buffer->readPtr(), buffer->readAble());
+
+  // 开始符、包长和结束符坏了不会走到 CRC 校验，只改中间的字节
+  for (size_t i = 5; i < frame.length() - 1; ++i)
+  {
+    std::string bad = frame;
+    bad[i] ^= 0x20;
+    rocket::TcpBuffer::s_ptr in = bufferOf(bad + frame);
+    std::vector<std::shared_ptr<rocket::TinyPBProtocol>> result = decodeAll(*server, in);
+    CHECK(result.size() == 1 && result[0]->m_msg_id == "100" && result[0]->m_pb_data == "payload");
+  }
+
+  printf("testBadCrc ok\n");
+  return true;
+}
+
+// 对端发来本端没有注册的方法号，解出来的方法名是 "#方法号"，交给上层按找不到方法处理
+static bool testUnknownMethodId()
+{
+  std::shared_ptr<rocket::TinyPBCoder> client, server;
+  CHECK(makeV2Pair(client, server));
+
+  rocket::TcpBuffer::s_ptr buffer = std::make_shared<rocket::TcpBuffer>(128);
+  encodeMessage(*client, makeMessage("7", KNOWN_METHOD, "data"), buffer);
+  std::string frame(buffer->readPtr(), buffer->readAble());
+  CHECK(frameFlags(frame) == 0);
+
+  // 方法号在开始符、包长、flags 和 8 字节 msg_id 之后
+  uint32_t method_id = 0x12345678;
+  uint32_t method_id_net = htonl(method_id);
+  memcpy(&frame[1 + 4 + 1 + 8], &method_id_net, sizeof(method_id_net));
+  resealFrameV2(frame);
+  std::string name;
+  CHECK(!rocket::TinyPBProtocol::GetMethodName(method_id, name));
+
+  std::vector<std::shared_ptr<rocket::TinyPBProtocol>> result = decodeAll(*server, bufferOf(frame));
+  CHECK(result.size() == 1);
+  CHECK(result[0]->m_method_name == "#" + std::to_string(method_id) && result[0]->m_msg_id == "7");
+
+  printf("testUnknownMethodId ok\n");
+  return true;
+}
+
+// 包头声明了一个大包时只先预留 MAX_PREALLOC_SIZE，剩下的随数据到达再扩容，最后照样解出完整的包
+static bool testLargeFrame()
+{
+  rocket::Config::GetGlobalConfig()->m_max_frame_size = 64 * 1024 * 1024;
+  std::shared_ptr<rocket::TinyPBCoder> client = makeCoder(false);
+  std::shared_ptr<rocket::TinyPBCoder> server = makeCoder(false);
+
+  std::string pb_data(3 * rocket::TinyPBCoder::MAX_PREALLOC_SIZE, 'p');
+  rocket::TcpBuffer::s_ptr buffer = std::make_shared<rocket::TcpBuffer>(128);
+  encodeMessage(*client, makeMessage("8", KNOWN_METHOD, pb_data), buffer);
+  std::string frame(buffer->readPtr(), buffer->readAble());
+
+  rocket::TcpBuffer::s_ptr in = std::make_shared<rocket::TcpBuffer>(128);
+  in->writeToBuffer(frame.data(), 64);
+  CHECK(decodeAll(*server, in).empty());
+  CHECK(in->capacity() <= rocket::TinyPBCoder::MAX_PREALLOC_SIZE + 128);
+
+  std::vector<std::shared_ptr<rocket::TinyPBProtocol>> result;
+  size_t chunk = 256 * 1024;
+  for (size_t pos = 64; pos < frame.length() && result.empty(); pos += chunk)
+  {
+    in->writeToBuffer(frame.data() + pos, (int)std::min(chunk, frame.length() - pos));
+    result = decodeAll(*server, in);
+  }
+  CHECK(result.size() == 1 && result[0]->m_msg_id == "8" && result[0]->m_pb_data == pb_data);
+
+  printf("testLargeFrame ok\n");
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc != 2)
+  {
+    printf("Start test_tinypb_coder error, argc not 2 \n");
+    printf("Start like this: \n");
+    printf("./test_tinypb_coder ../conf/rocket.xml \n");
+    return 0;
+  }
+
+  rocket::Config::SetGlobalConfig(argv[1]);
+  rocket::Config::GetGlobalConfig()->m_log_level = "ERROR";
+  rocket::Logger::InitGlobalLogger(0);
+
+  std::vector<std::string> method_names;
+  method_names.push_back(KNOWN_METHOD);
+  rocket::TinyPBProtocol::RegisterMethods(method_names);
+
+  bool ok = testNegotiate() && testV1Peer() && testV2Fields() && testGenMsgId() && testBadCrc() && testUnknownMethodId() && testLargeFrame();
+  printf(ok ? "test_tinypb_coder ok\n" : "test_tinypb_coder failed\n");
+  return ok ? 0 : 1;
+}